@@ -0,0 +1,95 @@
+//
+//  AABB.h
+//  OpenGLTest
+//
+//  Caixa envolvente alinhada aos eixos, usada pelas estruturas de
+//  aceleracao de colisao.
+//
+
+#ifndef AABB_hpp
+#define AABB_hpp
+
+#include <algorithm>
+using namespace std;
+
+#include "Ponto.h"
+
+struct AABB
+{
+    float minX, minY, maxX, maxY;
+
+    AABB() : minX(0), minY(0), maxX(0), maxY(0) {}
+    AABB(float x0, float y0, float x1, float y1) : minX(x0), minY(y0), maxX(x1), maxY(y1) {}
+
+    // Menor caixa que contem os n pontos
+    static AABB DosPontos(const Ponto *P, int n)
+    {
+        AABB B(P[0].x, P[0].y, P[0].x, P[0].y);
+        for (int i = 1; i < n; i++)
+            B.expande(P[i]);
+        return B;
+    }
+
+    void expande(const Ponto &P)
+    {
+        minX = min(minX, P.x);
+        minY = min(minY, P.y);
+        maxX = max(maxX, P.x);
+        maxY = max(maxY, P.y);
+    }
+
+    bool intersecta(const AABB &B) const
+    {
+        return minX <= B.maxX && B.minX <= maxX &&
+               minY <= B.maxY && B.minY <= maxY;
+    }
+
+    // true se B esta inteiramente dentro desta caixa
+    bool contem(const AABB &B) const
+    {
+        return minX <= B.minX && minY <= B.minY &&
+               B.maxX <= maxX && B.maxY <= maxY;
+    }
+
+    float perimetro() const
+    {
+        return 2 * ((maxX - minX) + (maxY - minY));
+    }
+
+    static AABB Uniao(const AABB &A, const AABB &B)
+    {
+        return AABB(min(A.minX, B.minX), min(A.minY, B.minY),
+                    max(A.maxX, B.maxX), max(A.maxY, B.maxY));
+    }
+
+    // Teste do segmento P0-P1 com a caixa (metodo das faixas). Se ha
+    // interseccao, t recebe o parametro (0..1) do ponto de entrada.
+    bool intersectaSegmento(const Ponto &P0, const Ponto &P1, float &t) const
+    {
+        float t0 = 0, t1 = 1;
+        float origem[2] = {P0.x, P0.y};
+        float direcao[2] = {P1.x - P0.x, P1.y - P0.y};
+        float lo[2] = {minX, minY}, hi[2] = {maxX, maxY};
+        for (int k = 0; k < 2; k++)
+        {
+            if (direcao[k] == 0)
+            {
+                if (origem[k] < lo[k] || origem[k] > hi[k])
+                    return false;
+                continue;
+            }
+            float ta = (lo[k] - origem[k]) / direcao[k];
+            float tb = (hi[k] - origem[k]) / direcao[k];
+            if (ta > tb)
+                swap(ta, tb);
+            t0 = max(t0, ta);
+            t1 = min(t1, tb);
+            if (t0 > t1)
+                return false;
+        }
+        t = t0;
+        return true;
+    }
+};
+
+#endif /* AABB_hpp */
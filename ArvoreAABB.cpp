@@ -0,0 +1,351 @@
+//
+//  ArvoreAABB.cpp
+//  OpenGLTest
+//
+
+#include <algorithm>
+#include "ArvoreAABB.h"
+
+const int ArvoreAABB::NULO;
+
+// Quantos passos de deslocamento a caixa gorda antecipa
+static const float ANTECIPACAO = 4.0f;
+
+ArvoreAABB::ArvoreAABB(float margem)
+{
+    Raiz = NULO;
+    Livre = NULO;
+    nFolhas = 0;
+    Margem = margem;
+    FatorDeDeslocamento = ANTECIPACAO;
+}
+
+void ArvoreAABB::setMargem(float m)
+{
+    if (m >= 0)
+        Margem = m;
+}
+
+float ArvoreAABB::getMargem() const
+{
+    return Margem;
+}
+
+void ArvoreAABB::limpa()
+{
+    Nos.clear();
+    Raiz = NULO;
+    Livre = NULO;
+    nFolhas = 0;
+}
+
+int ArvoreAABB::alocaNo()
+{
+    int n;
+    if (Livre == NULO)
+    {
+        n = (int)Nos.size();
+        Nos.push_back(No());
+    }
+    else
+    {
+        n = Livre;
+        Livre = Nos[n].Pai;
+    }
+    Nos[n].Pai = NULO;
+    Nos[n].Filho1 = Nos[n].Filho2 = NULO;
+    Nos[n].Altura = 0;
+    Nos[n].Dado = NULO;
+    return n;
+}
+
+void ArvoreAABB::liberaNo(int n)
+{
+    Nos[n].Pai = Livre;
+    Nos[n].Altura = -1;
+    Livre = n;
+}
+
+AABB ArvoreAABB::engorda(const AABB &caixa, const Ponto &deslocamento) const
+{
+    AABB G(caixa.minX - Margem, caixa.minY - Margem,
+           caixa.maxX + Margem, caixa.maxY + Margem);
+    float dx = deslocamento.x * FatorDeDeslocamento;
+    float dy = deslocamento.y * FatorDeDeslocamento;
+    if (dx < 0) G.minX += dx; else G.maxX += dx;
+    if (dy < 0) G.minY += dy; else G.maxY += dy;
+    return G;
+}
+
+int ArvoreAABB::insere(const AABB &caixa, int dado)
+{
+    int folha = alocaNo();
+    Nos[folha].Caixa = engorda(caixa, Ponto(0, 0));
+    Nos[folha].Dado = dado;
+    insereFolha(folha);
+    nFolhas++;
+    return folha;
+}
+
+void ArvoreAABB::remove(int proxy)
+{
+    removeFolha(proxy);
+    liberaNo(proxy);
+    nFolhas--;
+}
+
+bool ArvoreAABB::move(int proxy, const AABB &caixa, const Ponto &deslocamento)
+{
+    AABB gorda = engorda(caixa, deslocamento);
+    const AABB &atual = Nos[proxy].Caixa;
+    if (atual.contem(caixa))
+    {
+        // Ainda serve, a menos que tenha ficado grande demais (o objeto
+        // andava rapido e parou): ai vale reinserir com a caixa menor
+        float folga = 4 * Margem;
+        AABB enorme(gorda.minX - folga, gorda.minY - folga,
+                    gorda.maxX + folga, gorda.maxY + folga);
+        if (enorme.contem(atual))
+            return false;
+    }
+    removeFolha(proxy);
+    Nos[proxy].Caixa = gorda;
+    insereFolha(proxy);
+    return true;
+}
+
+// Desce pelo filho cuja caixa cresce menos (em perimetro) ao receber a
+// folha e pendura a folha ao lado do no onde parou
+void ArvoreAABB::insereFolha(int folha)
+{
+    if (Raiz == NULO)
+    {
+        Raiz = folha;
+        Nos[folha].Pai = NULO;
+        return;
+    }
+
+    AABB caixa = Nos[folha].Caixa;
+    int n = Raiz;
+    while (!ehFolha(n))
+    {
+        int c1 = Nos[n].Filho1, c2 = Nos[n].Filho2;
+        float perimetro = Nos[n].Caixa.perimetro();
+        float combinado = AABB::Uniao(Nos[n].Caixa, caixa).perimetro();
+
+        // Custo de criar um novo pai para n e a folha
+        float custo = 2 * combinado;
+        // Custo minimo de descer: todos os ancestrais crescem
+        float herdado = 2 * (combinado - perimetro);
+
+        float custo1 = AABB::Uniao(caixa, Nos[c1].Caixa).perimetro() + herdado;
+        if (!ehFolha(c1))
+            custo1 -= Nos[c1].Caixa.perimetro();
+        float custo2 = AABB::Uniao(caixa, Nos[c2].Caixa).perimetro() + herdado;
+        if (!ehFolha(c2))
+            custo2 -= Nos[c2].Caixa.perimetro();
+
+        if (custo < custo1 && custo < custo2)
+            break;
+        n = (custo1 < custo2) ? c1 : c2;
+    }
+
+    int irmao = n;
+    int antigoPai = Nos[irmao].Pai;
+    int novoPai = alocaNo();
+    Nos[novoPai].Pai = antigoPai;
+    Nos[novoPai].Caixa = AABB::Uniao(caixa, Nos[irmao].Caixa);
+    Nos[novoPai].Altura = Nos[irmao].Altura + 1;
+    Nos[novoPai].Filho1 = irmao;
+    Nos[novoPai].Filho2 = folha;
+    Nos[irmao].Pai = novoPai;
+    Nos[folha].Pai = novoPai;
+
+    if (antigoPai == NULO)
+        Raiz = novoPai;
+    else if (Nos[antigoPai].Filho1 == irmao)
+        Nos[antigoPai].Filho1 = novoPai;
+    else
+        Nos[antigoPai].Filho2 = novoPai;
+
+    ajustaAcima(antigoPai);
+}
+
+// Tira a folha e poe o irmao no lugar do pai
+void ArvoreAABB::removeFolha(int folha)
+{
+    if (folha == Raiz)
+    {
+        Raiz = NULO;
+        return;
+    }
+
+    int pai = Nos[folha].Pai;
+    int avo = Nos[pai].Pai;
+    int irmao = (Nos[pai].Filho1 == folha) ? Nos[pai].Filho2 : Nos[pai].Filho1;
+
+    liberaNo(pai);
+    Nos[folha].Pai = NULO;
+    if (avo == NULO)
+    {
+        Raiz = irmao;
+        Nos[irmao].Pai = NULO;
+        return;
+    }
+    if (Nos[avo].Filho1 == pai)
+        Nos[avo].Filho1 = irmao;
+    else
+        Nos[avo].Filho2 = irmao;
+    Nos[irmao].Pai = avo;
+    ajustaAcima(avo);
+}
+
+void ArvoreAABB::ajustaAcima(int n)
+{
+    while (n != NULO)
+    {
+        n = balanceia(n);
+        int c1 = Nos[n].Filho1, c2 = Nos[n].Filho2;
+        Nos[n].Altura = 1 + max(Nos[c1].Altura, Nos[c2].Altura);
+        Nos[n].Caixa = AABB::Uniao(Nos[c1].Caixa, Nos[c2].Caixa);
+        n = Nos[n].Pai;
+    }
+}
+
+// Se as alturas dos filhos de a diferem de mais de 1, o filho mais alto
+// sobe para o lugar de a (rotacao). Retorna o no que ficou no lugar de a.
+int ArvoreAABB::balanceia(int a)
+{
+    if (ehFolha(a) || Nos[a].Altura < 2)
+        return a;
+
+    int b = Nos[a].Filho1, c = Nos[a].Filho2;
+    int diferenca = Nos[c].Altura - Nos[b].Altura;
+    if (diferenca >= -1 && diferenca <= 1)
+        return a;
+
+    // "sobe" eh o filho mais alto, "fica" o outro
+    bool sobeC = diferenca > 1;
+    int sobe = sobeC ? c : b;
+    int fica = sobeC ? b : c;
+    int f = Nos[sobe].Filho1, g = Nos[sobe].Filho2;
+
+    // sobe passa a ser pai de a
+    Nos[sobe].Filho1 = a;
+    Nos[sobe].Pai = Nos[a].Pai;
+    Nos[a].Pai = sobe;
+    int paiAntigo = Nos[sobe].Pai;
+    if (paiAntigo == NULO)
+        Raiz = sobe;
+    else if (Nos[paiAntigo].Filho1 == a)
+        Nos[paiAntigo].Filho1 = sobe;
+    else
+        Nos[paiAntigo].Filho2 = sobe;
+
+    // O neto mais alto fica com "sobe"; o outro vai para a
+    if (Nos[f].Altura < Nos[g].Altura)
+        swap(f, g);
+    Nos[sobe].Filho2 = f;
+    if (sobeC)
+        Nos[a].Filho2 = g;
+    else
+        Nos[a].Filho1 = g;
+    Nos[g].Pai = a;
+
+    Nos[a].Caixa = AABB::Uniao(Nos[fica].Caixa, Nos[g].Caixa);
+    Nos[a].Altura = 1 + max(Nos[fica].Altura, Nos[g].Altura);
+    Nos[sobe].Caixa = AABB::Uniao(Nos[a].Caixa, Nos[f].Caixa);
+    Nos[sobe].Altura = 1 + max(Nos[a].Altura, Nos[f].Altura);
+    return sobe;
+}
+
+void ArvoreAABB::consultaFolhas(const AABB &caixa, vector<int> &folhas) const
+{
+    folhas.clear();
+    if (Raiz == NULO)
+        return;
+    Pilha.clear();
+    Pilha.push_back(Raiz);
+    while (!Pilha.empty())
+    {
+        int n = Pilha.back();
+        Pilha.pop_back();
+        if (!Nos[n].Caixa.intersecta(caixa))
+            continue;
+        if (ehFolha(n))
+            folhas.push_back(n);
+        else
+        {
+            Pilha.push_back(Nos[n].Filho1);
+            Pilha.push_back(Nos[n].Filho2);
+        }
+    }
+}
+
+void ArvoreAABB::consulta(const AABB &caixa, vector<int> &dados) const
+{
+    consultaFolhas(caixa, dados);
+    for (size_t k = 0; k < dados.size(); k++)
+        dados[k] = Nos[dados[k]].Dado;
+}
+
+// Cada folha consulta a arvore com a propria caixa; o par (p, q) so eh
+// anotado quando p < q, para nao sair duas vezes
+void ArvoreAABB::obtemPares(vector<ParDaArvore> &pares) const
+{
+    pares.clear();
+    vector<int> folhas;
+    for (int p = 0; p < (int)Nos.size(); p++)
+    {
+        if (Nos[p].Altura != 0)
+            continue; // no interno ou livre
+        consultaFolhas(Nos[p].Caixa, folhas);
+        for (int q : folhas)
+            if (q > p)
+                pares.push_back({Nos[p].Dado, Nos[q].Dado});
+    }
+}
+
+void ArvoreAABB::raio(const Ponto &P0, const Ponto &P1, vector<AcertoDoRaio> &acertos) const
+{
+    acertos.clear();
+    if (Raiz == NULO)
+        return;
+    Pilha.clear();
+    Pilha.push_back(Raiz);
+    while (!Pilha.empty())
+    {
+        int n = Pilha.back();
+        Pilha.pop_back();
+        float t;
+        if (!Nos[n].Caixa.intersectaSegmento(P0, P1, t))
+            continue;
+        if (ehFolha(n))
+            acertos.push_back({Nos[n].Dado, t});
+        else
+        {
+            Pilha.push_back(Nos[n].Filho1);
+            Pilha.push_back(Nos[n].Filho2);
+        }
+    }
+    sort(acertos.begin(), acertos.end(),
+         [](const AcertoDoRaio &A, const AcertoDoRaio &B) { return A.t < B.t; });
+}
+
+int ArvoreAABB::getAltura() const
+{
+    return (Raiz == NULO) ? 0 : Nos[Raiz].Altura;
+}
+
+void ArvoreAABB::obtemCaixas(vector<AABB> &caixas, vector<char> &folha) const
+{
+    caixas.clear();
+    folha.clear();
+    for (int n = 0; n < (int)Nos.size(); n++)
+    {
+        if (Nos[n].Altura < 0)
+            continue;
+        caixas.push_back(Nos[n].Caixa);
+        folha.push_back(ehFolha(n));
+    }
+}
@@ -0,0 +1,120 @@
+//
+//  ArvoreAABB.h
+//  OpenGLTest
+//
+//  Arvore dinamica de caixas envolventes (BVH) para a fase ampla da
+//  deteccao de colisao. Ao contrario da GradeEspacial, que eh refeita
+//  a cada passo, a arvore eh mantida entre os passos:
+//
+//      int p = Arvore.insere(caixa, id);   // entidade entra
+//      Arvore.move(p, caixa, deslocamento); // a cada passo
+//      Arvore.remove(p);                    // entidade sai
+//
+//  Cada folha guarda uma caixa "gorda": a caixa real aumentada de uma
+//  margem e esticada na direcao do deslocamento. Enquanto a caixa real
+//  continuar dentro da gorda, move() nao mexe na arvore; como os
+//  personagens andam pouco por passo, a maioria dos passos nao gera
+//  nenhuma atualizacao.
+//
+//  As consultas devolvem candidatos pelas caixas gordas; o teste exato
+//  fica por conta de quem chama. Os nos internos sao escolhidos pelo
+//  menor perimetro da uniao e a arvore eh balanceada por rotacoes,
+//  como uma AVL, para nao degenerar quando os objetos se alinham.
+//
+//  Complementa a grade: nao depende de um tamanho de celula, o que
+//  ajuda em cenas com densidade de objetos muito desigual.
+//
+
+#ifndef ArvoreAABB_hpp
+#define ArvoreAABB_hpp
+
+#include <vector>
+using namespace std;
+
+#include "Ponto.h"
+#include "AABB.h"
+
+// Par de objetos cujas caixas gordas se sobrepoem
+struct ParDaArvore
+{
+    int a, b;
+};
+
+// Objeto cuja caixa gorda eh atravessada pelo raio, e o parametro
+// (0..1) do ponto de entrada
+struct AcertoDoRaio
+{
+    int Dado;
+    float t;
+};
+
+class ArvoreAABB
+{
+    struct No
+    {
+        AABB Caixa;
+        int Pai;            // nos livres: proximo da lista de livres
+        int Filho1, Filho2; // NULO nas folhas
+        int Altura;         // 0 nas folhas, -1 nos livres
+        int Dado;           // so nas folhas
+    };
+
+    vector<No> Nos;
+    int Raiz;
+    int Livre;          // inicio da lista de nos livres
+    int nFolhas;
+    float Margem;
+    float FatorDeDeslocamento;
+    mutable vector<int> Pilha;
+
+    int alocaNo();
+    void liberaNo(int n);
+    bool ehFolha(int n) const { return Nos[n].Filho1 == NULO; }
+    void insereFolha(int folha);
+    void removeFolha(int folha);
+    void ajustaAcima(int n);   // balanceia e recalcula caixas ate a raiz
+    int balanceia(int a);
+    AABB engorda(const AABB &caixa, const Ponto &deslocamento) const;
+    void consultaFolhas(const AABB &caixa, vector<int> &folhas) const;
+public:
+    static const int NULO = -1;
+
+    ArvoreAABB(float margem = 0.5f);
+
+    // Margem das caixas gordas; so vale para as proximas atualizacoes
+    void setMargem(float m);
+    float getMargem() const;
+
+    void limpa();
+
+    // Acrescenta um objeto e retorna o seu identificador na arvore
+    int insere(const AABB &caixa, int dado);
+    void remove(int proxy);
+
+    // Informa a nova caixa do objeto e o quanto ele andou no ultimo
+    // passo. Retorna true se a folha precisou ser reinserida.
+    bool move(int proxy, const AABB &caixa, const Ponto &deslocamento);
+
+    int getDado(int proxy) const { return Nos[proxy].Dado; }
+    void setDado(int proxy, int dado) { Nos[proxy].Dado = dado; }
+    const AABB &getCaixaGorda(int proxy) const { return Nos[proxy].Caixa; }
+
+    // Dados dos objetos cuja caixa gorda toca a caixa consultada
+    void consulta(const AABB &caixa, vector<int> &dados) const;
+
+    // Todos os pares de objetos com caixas gordas sobrepostas, cada
+    // par uma vez
+    void obtemPares(vector<ParDaArvore> &pares) const;
+
+    // Objetos cuja caixa gorda cruza o segmento P0-P1, do mais proximo
+    // de P0 para o mais distante
+    void raio(const Ponto &P0, const Ponto &P1, vector<AcertoDoRaio> &acertos) const;
+
+    int getNroDeObjetos() const { return nFolhas; }
+    int getAltura() const;
+
+    // Caixas de todos os nos, para depuracao; folha[k] indica se o no k eh folha
+    void obtemCaixas(vector<AABB> &caixas, vector<char> &folha) const;
+};
+
+#endif /* ArvoreAABB_hpp */
@@ -0,0 +1,1026 @@
+// **********************************************************************
+//  Benchmark.cpp
+//  Medicoes de desempenho feitas sem janela.
+//
+//  Uso: ./Benchmark <teste> [parametros]
+//
+//  Testes:
+//    leitura [n]  - gera um poligono com n vertices (padrao 10000000),
+//                   le com LePoligonoStream, com LePoligono (gravando o
+//                   cache) e com LePoligono de novo (lendo o cache) e
+//                   compara os resultados.
+//    faixas [arquivo] [nFaixas] [nConsultas]
+//                 - tempo por consulta de ponto-no-poligono com o indice
+//                   de faixas e com forca bruta (padrao: EstadoRS.txt,
+//                   faixas automaticas, 1000000 consultas). Confere
+//                   tambem pontos logo abaixo do topo do poligono e de
+//                   triangulos aleatorios.
+//    classifica [poligono] [pontos] [threads]
+//                 - classifica em lote (dentro/fora/borda) os pontos do
+//                   arquivo "pontos" (mesmo formato dos poligonos) ou,
+//                   se for um numero, tantos pontos aleatorios (padrao
+//                   10000000), com 1, 2, 4... ate "threads" threads
+//                   (padrao: uma por nucleo), e informa pontos/s.
+//    hull [nMin] [nMax] [threads]
+//                 - compara os metodos de fecho convexo em nuvens
+//                   uniformes num quadrado e num disco e em pontos
+//                   inteiros de uma grade (com empates e repetidos), de
+//                   nMin (padrao 10000) a nMax (padrao 10000000) pontos.
+//                   Confere tambem 1000 nuvens pequenas numa grade 20x20
+//                   e pontos todos iguais.
+//    triangula [nMax] - triangula EstadoRS.txt e poligonos estrelados
+//                   aleatorios de 1000 a nMax (padrao 1000000) vertices,
+//                   conferindo a soma das areas dos triangulos.
+//    consultas [nMin] [nMax] [nConsultas] [distribuicao]
+//                 - constroi a quadtree e a kd-tree com nuvens (uniforme,
+//                   agrupada ou grade; padrao uniforme) de nMin (padrao
+//                   1000) a nMax (padrao 10000000) pontos
+//                   e mede o tempo por consulta de pontos no triangulo
+//                   (campo de visao), dos 16 mais proximos e dos pontos
+//                   num raio, contra a forca bruta (padrao: 1000
+//                   consultas; menos na forca bruta para n grande).
+//                   "varredura" eh a forca bruta vetorizada sobre x[]/y[].
+//    kernel [nMin] [nMax]
+//                 - pontos por segundo do teste de ponto no triangulo:
+//                   com lado(), com as funcoes de aresta sobre Ponto e
+//                   com FiltraPontosNoTriangulo (escalar, SSE2, AVX2)
+//                   sobre x[]/y[], de nMin (padrao 1000) a nMax (padrao
+//                   10000000) pontos.
+//    incremental [n] [passos] [distribuicao]
+//                 - anda com o campo de visao sobre uma nuvem de n pontos
+//                   (padrao 1000000, uniforme), como as setas de PontosNoTriangulo
+//                   (2 graus ou 1/250 da largura por passo), e mede o
+//                   custo de obter os eventos de entrada e saida: com a
+//                   consulta completa na quadtree mais a comparacao com
+//                   o conjunto anterior, e com a consulta incremental
+//                   (padrao: 2000 passos). A consulta completa sozinha,
+//                   sem eventos, aparece como referencia.
+//    gera [n] [threads]
+//                 - gera n pontos (padrao 10000000) em cada distribuicao
+//                   do GeradorDePontos com 1, 2, 4... ate "threads"
+//                   threads (padrao: uma por nucleo), confere que o
+//                   resultado nao depende do numero de threads e conta
+//                   as posicoes repetidas, comparando com rand() % 1000.
+// **********************************************************************
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+#include "Poligono.h"
+#include "LeitorDePoligonos.h"
+#include "ConjuntoDeFaixas.h"
+#include "ClassificadorDePontos.h"
+#include "FechoConvexo.h"
+#include "Triangulacao.h"
+#include "TrianguloDeConsulta.h"
+#include "QuadTreeDePontos.h"
+#include "KdTreeDePontos.h"
+#include "CampoDeVisaoIncremental.h"
+#include "GeradorDePontos.h"
+#include "Temporizador.h"
+
+// **********************************************************************
+//  leitura
+// **********************************************************************
+static void GeraArquivoDePoligono(const char *nome, long n)
+{
+    FILE *f = fopen(nome, "w");
+    if (f == NULL)
+    {
+        cout << "Erro ao criar " << nome << endl;
+        exit(1);
+    }
+    fprintf(f, "%ld\n", n);
+    srand(1);
+    for (long i = 0; i < n; i++)
+    {
+        double x = (rand() % 2000000) / 1000.0 - 1000.0;
+        double y = (rand() % 2000000) / 1000.0 - 1000.0;
+        fprintf(f, "%.6f %.6f\n", x, y);
+    }
+    fclose(f);
+}
+
+// Numero de vertices diferentes (ou -1 se a quantidade difere)
+static long ContaDiferencas(Poligono &A, Poligono &B)
+{
+    if (A.getNVertices() != B.getNVertices())
+        return -1;
+    long diferentes = 0;
+    for (unsigned long i = 0; i < A.getNVertices(); i++)
+    {
+        Ponto a = A.getVertice(i), b = B.getVertice(i);
+        if (a.x != b.x || a.y != b.y)
+            diferentes++;
+    }
+    return diferentes;
+}
+
+static int BenchLeitura(int argc, char **argv)
+{
+    long n = (argc > 0) ? atol(argv[0]) : 10000000;
+    const char *nome = "bench_poligono.txt";
+
+    Temporizador T;
+    GeraArquivoDePoligono(nome, n);
+    cout << "Arquivo com " << n << " vertices gerado em " << T.getDeltaT() << " s" << endl;
+
+    string cache = NomeDoCache(nome);
+    remove(cache.c_str());
+
+    Poligono A, B, C;
+    T.getDeltaT();
+    A.LePoligonoStream(nome);
+    double tStream = T.getDeltaT();
+    B.LePoligono(nome);
+    double tMapeado = T.getDeltaT();
+    C.LePoligono(nome);
+    double tCache = T.getDeltaT();
+
+    long dB = ContaDiferencas(A, B), dC = ContaDiferencas(A, C);
+    remove(nome);
+    remove(cache.c_str());
+
+    cout << setprecision(3) << fixed;
+    cout << "ifstream:           " << tStream << " s" << endl;
+    cout << "mmap + grava cache: " << tMapeado << " s (" << tStream / tMapeado << "x)" << endl;
+    cout << "cache binario:      " << tCache << " s (" << tStream / tCache << "x)" << endl;
+    if (dB != 0 || dC != 0)
+    {
+        cout << "ERRO: resultados diferentes (mmap: " << dB << ", cache: " << dC << ")" << endl;
+        return 1;
+    }
+    cout << "Resultados iguais (" << B.getNVertices() << " vertices)" << endl;
+    return 0;
+}
+
+// **********************************************************************
+//  faixas
+// **********************************************************************
+
+// Pontos aleatorios (com semente fixa) na caixa envolvente do poligono
+static void GeraPontosNaCaixa(Poligono &P, long n, vector<Ponto> &Pontos)
+{
+    Ponto Min, Max;
+    P.obtemLimites(Min, Max);
+    srand(2);
+    Pontos.resize(n);
+    for (long i = 0; i < n; i++)
+    {
+        float u = rand() / (float)RAND_MAX;
+        float v = rand() / (float)RAND_MAX;
+        Pontos[i] = Ponto(Min.x + u * (Max.x - Min.x), Min.y + v * (Max.y - Min.y));
+    }
+}
+
+// Pontos logo abaixo do topo do poligono: y = YMax e os floats
+// imediatamente menores, onde o calculo da faixa arredonda para fora
+static void GeraPontosNoTopo(Poligono &P, long n, vector<Ponto> &Pontos)
+{
+    Ponto Min, Max;
+    P.obtemLimites(Min, Max);
+    srand(4);
+    Pontos.resize(n);
+    for (long i = 0; i < n; i++)
+    {
+        float y = Max.y;
+        for (int k = rand() % 8; k > 0; k--)
+            y = nextafterf(y, Min.y);
+        Pontos[i] = Ponto(Min.x + rand() / (float)RAND_MAX * (Max.x - Min.x), y);
+    }
+}
+
+// Triangulos aleatorios consultados logo abaixo do vertice de cima;
+// retorna quantos classificam diferente da forca bruta
+static long DiferencasNoTopoDeTriangulos(int nTriangulos)
+{
+    srand(5);
+    long diferentes = 0;
+    for (int t = 0; t < nTriangulos; t++)
+    {
+        Poligono Tri;
+        for (int k = 0; k < 3; k++)
+            Tri.insereVertice(Ponto(2000 * (rand() / (float)RAND_MAX) - 1000, 2000 * (rand() / (float)RAND_MAX) - 1000));
+        ConjuntoDeFaixas F;
+        F.Constroi(Tri, 1 + rand() % 64);
+        Ponto Min, Max, Apice;
+        Tri.obtemLimites(Min, Max);
+        for (int k = 0; k < 3; k++)
+            if (Tri.getVertice(k).y == Max.y)
+                Apice = Tri.getVertice(k);
+        // um pouco abaixo do apice, entre as duas arestas
+        Ponto Q(Apice.x, Apice.y - (Max.y - Min.y) * 1e-5f);
+        if ((ContaCruzamentosForcaBruta(Tri, Q) & 1) != (int)F.PontoDentro(Q))
+            diferentes++;
+    }
+    return diferentes;
+}
+
+static int BenchFaixas(int argc, char **argv)
+{
+    const char *nome = (argc > 0) ? argv[0] : "EstadoRS.txt";
+    int nFaixas = (argc > 1) ? atoi(argv[1]) : 0;
+    long nConsultas = (argc > 2) ? atol(argv[2]) : 1000000;
+
+    Poligono Mapa;
+    Mapa.LePoligono(nome);
+
+    Temporizador T;
+    ConjuntoDeFaixas Faixas;
+    Faixas.Constroi(Mapa, nFaixas);
+    double tConstroi = T.getDeltaT();
+
+    vector<Ponto> Pontos;
+    GeraPontosNaCaixa(Mapa, nConsultas, Pontos);
+
+    T.getDeltaT();
+    long dentro = 0;
+    for (long i = 0; i < nConsultas; i++)
+        dentro += Faixas.PontoDentro(Pontos[i]);
+    double tFaixas = T.getDeltaT();
+
+    // A forca bruta eh muito mais lenta; usa uma amostra e compara
+    long nBruta = min(nConsultas, 20000L);
+    long diferentes = 0;
+    T.getDeltaT();
+    for (long i = 0; i < nBruta; i++)
+        if ((ContaCruzamentosForcaBruta(Mapa, Pontos[i]) & 1) != (int)Faixas.PontoDentro(Pontos[i]))
+            diferentes++;
+    double tBruta = T.getDeltaT();
+
+    cout << setprecision(3) << fixed;
+    cout << Mapa.getNVertices() << " arestas, " << Faixas.getNroDeFaixas() << " faixas, ";
+    cout << Faixas.getNroDeCadastros() << " cadastros, construcao em " << tConstroi * 1000 << " ms" << endl;
+    cout << "faixas:       " << tFaixas / nConsultas * 1e9 << " ns/consulta (" << dentro << " de " << nConsultas << " dentro)" << endl;
+    cout << "forca bruta:  " << tBruta / nBruta * 1e9 << " ns/consulta" << endl;
+    if (diferentes != 0)
+    {
+        cout << "ERRO: " << diferentes << " consultas diferentes" << endl;
+        return 1;
+    }
+    cout << "Resultados iguais (" << nBruta << " consultas comparadas)" << endl;
+
+    // Regressao: o topo do poligono tem que cair na ultima faixa
+    GeraPontosNoTopo(Mapa, 2000, Pontos);
+    for (size_t i = 0; i < Pontos.size(); i++)
+        if ((ContaCruzamentosForcaBruta(Mapa, Pontos[i]) & 1) != (int)Faixas.PontoDentro(Pontos[i]))
+            diferentes++;
+    long nosTriangulos = DiferencasNoTopoDeTriangulos(2000);
+    if (diferentes != 0 || nosTriangulos != 0)
+    {
+        cout << "ERRO: perto do topo, " << diferentes << " de " << Pontos.size() << " pontos do poligono e "
+             << nosTriangulos << " de 2000 triangulos diferentes" << endl;
+        return 1;
+    }
+    cout << "Perto do topo: " << Pontos.size() << " pontos e 2000 triangulos iguais" << endl;
+    return 0;
+}
+
+// **********************************************************************
+//  classifica
+// **********************************************************************
+static int BenchClassifica(int argc, char **argv)
+{
+    const char *nome = (argc > 0) ? argv[0] : "EstadoRS.txt";
+    const char *pontos = (argc > 1) ? argv[1] : "10000000";
+    int maxThreads = (argc > 2) ? atoi(argv[2]) : 0;
+
+    Poligono Mapa;
+    Mapa.LePoligono(nome);
+
+    vector<Ponto> Pontos;
+    string erro;
+    ResultadoDaLeitura r = LeVerticesDoArquivo(pontos, Pontos, erro);
+    if (r == LEITURA_MAL_FORMADO)
+    {
+        cout << erro << endl;
+        return 1;
+    }
+    if (r == LEITURA_SEM_ARQUIVO)
+    {
+        // Pontos aleatorios; alguns exatamente sobre os vertices, para
+        // exercitar a borda
+        GeraPontosNaCaixa(Mapa, atol(pontos), Pontos);
+        for (size_t i = 0; i < Pontos.size(); i += 1000)
+            Pontos[i] = Mapa.getVertice((int)(i / 1000 % Mapa.getNVertices()));
+    }
+    long n = (long)Pontos.size();
+    cout << n << " pontos" << endl;
+
+    Temporizador T;
+    ClassificadorDePontos C;
+    C.Constroi(Mapa);
+    cout << "Indice construido em " << T.getDeltaT() * 1000 << " ms (tolerancia da borda: " << C.getTolerancia() << ")" << endl;
+    if (maxThreads <= 0)
+        maxThreads = C.getNroDeThreads();
+
+    vector<unsigned char> Resultado(n), Referencia;
+    cout << setprecision(3) << fixed;
+    for (int t = 1;; t = min(2 * t, maxThreads))
+    {
+        C.setNroDeThreads(t);
+        T.getDeltaT();
+        C.Classifica(Pontos.empty() ? NULL : &Pontos[0], n, Resultado.empty() ? NULL : &Resultado[0]);
+        double dt = T.getDeltaT();
+        cout << t << " thread(s): " << n / dt / 1e6 << " milhoes de pontos/s" << endl;
+        if (Referencia.empty())
+            Referencia = Resultado;
+        else if (Resultado != Referencia)
+        {
+            cout << "ERRO: resultado depende do numero de threads" << endl;
+            return 1;
+        }
+        if (t == maxThreads)
+            break;
+    }
+
+    long cont[3] = {0, 0, 0};
+    for (long i = 0; i < n; i++)
+        cont[Resultado[i]]++;
+    cout << "dentro: " << cont[PONTO_DENTRO] << "  fora: " << cont[PONTO_FORA];
+    cout << "  borda: " << cont[PONTO_NA_BORDA] << endl;
+
+    // Confere uma amostra com a forca bruta
+    long diferentes = 0, amostra = 0;
+    for (long i = 0; i < n; i += max(1L, n / 20000), amostra++)
+        if (ClassificaPontoForcaBruta(Mapa, Pontos[i], C.getTolerancia()) != Resultado[i])
+            diferentes++;
+    if (diferentes != 0)
+    {
+        cout << "ERRO: " << diferentes << " de " << amostra << " pontos diferentes da forca bruta" << endl;
+        return 1;
+    }
+    cout << "Amostra de " << amostra << " pontos igual a forca bruta" << endl;
+    return 0;
+}
+
+// **********************************************************************
+//  hull
+// **********************************************************************
+static void GeraNuvem(long n, bool disco, vector<Ponto> &Pontos)
+{
+    srand(3);
+    Pontos.resize(n);
+    for (long i = 0; i < n; i++)
+    {
+        float u = rand() / (float)RAND_MAX;
+        float v = rand() / (float)RAND_MAX;
+        if (disco)
+        {
+            float r = 1000 * sqrt(u), a = 2 * M_PI * v;
+            Pontos[i] = Ponto(r * cos(a), r * sin(a));
+        }
+        else
+            Pontos[i] = Ponto(2000 * u - 1000, 2000 * v - 1000);
+    }
+}
+
+// Coordenadas inteiras em [0, lado): arestas do fecho paralelas e
+// pontos repetidos sao comuns
+static void GeraNuvemEmGrade(long n, int lado, vector<Ponto> &Pontos)
+{
+    Pontos.resize(n);
+    for (long i = 0; i < n; i++)
+        Pontos[i] = Ponto(rand() % lado, rand() % lado);
+}
+
+static bool FechosIguais(const vector<Ponto> &A, const vector<Ponto> &B)
+{
+    if (A.size() != B.size())
+        return false;
+    for (size_t i = 0; i < A.size(); i++)
+        if (A[i].x != B[i].x || A[i].y != B[i].y)
+            return false;
+    return true;
+}
+
+static int BenchHull(int argc, char **argv)
+{
+    long nMin = (argc > 0) ? atol(argv[0]) : 10000;
+    long nMax = (argc > 1) ? atol(argv[1]) : 10000000;
+    int threads = (argc > 2) ? atoi(argv[2]) : 0;
+
+    struct Variante
+    {
+        const char *Nome;
+        MetodoDoFecho Metodo;
+        bool Filtro;
+        int Threads;
+    } Variantes[] = {
+        {"monotono", FECHO_MONOTONO, false, 1},
+        {"monotono+filtro", FECHO_MONOTONO, true, 1},
+        {"quickhull 1t", FECHO_QUICKHULL, false, 1},
+        {"quickhull", FECHO_QUICKHULL, false, threads},
+        {"quickhull+filtro", FECHO_QUICKHULL, true, threads},
+    };
+    int nVariantes = sizeof(Variantes) / sizeof(Variantes[0]);
+
+    cout << setprecision(2) << fixed;
+    Temporizador T;
+    bool erro = false;
+    const char *Nuvens[] = {"quadrado", "disco   ", "grade   "};
+    for (int nuvem = 0; nuvem < 3; nuvem++)
+        for (long n = nMin; n <= nMax; n *= 10)
+        {
+            vector<Ponto> Pontos, Referencia, Fecho;
+            if (nuvem == 2)
+            {
+                srand(3);
+                GeraNuvemEmGrade(n, 1000, Pontos);
+            }
+            else
+                GeraNuvem(n, nuvem == 1, Pontos);
+            cout << Nuvens[nuvem] << " n=" << setw(8) << n << ":";
+            for (int v = 0; v < nVariantes; v++)
+            {
+                T.getDeltaT();
+                CalculaFechoConvexo(Pontos, Fecho, Variantes[v].Metodo, Variantes[v].Filtro, Variantes[v].Threads);
+                double dt = T.getDeltaT();
+                cout << "  " << Variantes[v].Nome << " " << dt * 1000 << " ms";
+                if (v == 0)
+                    Referencia = Fecho;
+                else if (!FechosIguais(Fecho, Referencia))
+                {
+                    cout << " (DIFERENTE)";
+                    erro = true;
+                }
+            }
+            cout << "  [" << Referencia.size() << " vertices]" << endl;
+        }
+
+    // Nuvens pequenas em grade e pontos todos iguais: empates na
+    // distancia do quickhull e fechos degenerados
+    int diferentes = 0;
+    for (int caso = 0; caso < 1001; caso++)
+    {
+        vector<Ponto> Pontos, Referencia, Fecho;
+        srand(caso);
+        if (caso < 1000)
+            GeraNuvemEmGrade(3 + rand() % 40, 20, Pontos);
+        else
+            Pontos.assign(5, Ponto(7, 7));
+        for (int v = 0; v < nVariantes; v++)
+        {
+            CalculaFechoConvexo(Pontos, Fecho, Variantes[v].Metodo, Variantes[v].Filtro, Variantes[v].Threads);
+            if (v == 0)
+                Referencia = Fecho;
+            else if (!FechosIguais(Fecho, Referencia))
+            {
+                diferentes++;
+                break;
+            }
+        }
+    }
+    cout << "grade 20x20 e pontos iguais: " << diferentes << " de 1001 casos diferentes" << endl;
+    if (diferentes > 0)
+        erro = true;
+    if (erro)
+    {
+        cout << "ERRO: os metodos deram fechos diferentes" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// **********************************************************************
+//  triangula
+// **********************************************************************
+
+// Triangula e confere: n-2 triangulos, todos anti-horarios e com a
+// soma das areas igual a area do poligono
+static bool TestaTriangulacao(const char *nome, const vector<Ponto> &V)
+{
+    Temporizador T;
+    vector<unsigned> I;
+    bool ok = TriangulaPoligono(V, I);
+    double dt = T.getDeltaT();
+
+    double area = 0, areaTriangulos = 0;
+    long invertidos = 0;
+    for (size_t i = 0; i < V.size(); i++)
+    {
+        const Ponto &A = V[i], &B = V[(i + 1) % V.size()];
+        area += ((double)A.x * B.y - (double)B.x * A.y) / 2;
+    }
+    for (size_t i = 0; i + 2 < I.size(); i += 3)
+    {
+        const Ponto &A = V[I[i]], &B = V[I[i + 1]], &C = V[I[i + 2]];
+        double t = (((double)B.x - A.x) * ((double)C.y - A.y) - ((double)B.y - A.y) * ((double)C.x - A.x)) / 2;
+        if (t < 0)
+            invertidos++;
+        areaTriangulos += t;
+    }
+    ok = ok && invertidos == 0 && fabs(areaTriangulos - fabs(area)) <= 1e-6 * fabs(area);
+    cout << setw(10) << nome << " n=" << setw(8) << V.size() << ": " << setw(10) << dt * 1000 << " ms, ";
+    cout << I.size() / 3 << " triangulos" << (ok ? "" : "  ERRO") << endl;
+    return ok;
+}
+
+static int BenchTriangula(int argc, char **argv)
+{
+    long nMax = (argc > 0) ? atol(argv[0]) : 1000000;
+    cout << setprecision(2) << fixed;
+    bool ok = true;
+
+    vector<Ponto> V;
+    string erro;
+    if (LeVerticesDoArquivo("EstadoRS.txt", V, erro) == LEITURA_OK)
+        ok = TestaTriangulacao("EstadoRS", V) && ok;
+
+    srand(4);
+    for (long n = 1000; n <= nMax; n *= 10)
+    {
+        V.resize(n);
+        for (long i = 0; i < n; i++)
+        {
+            double a = 2 * M_PI * i / n, r = 500 + 500 * (rand() / (double)RAND_MAX);
+            V[i] = Ponto(r * cos(a), r * sin(a));
+        }
+        ok = TestaTriangulacao("estrela", V) && ok;
+    }
+    return ok ? 0 : 1;
+}
+
+// **********************************************************************
+//  consultas
+// **********************************************************************
+// Campo de visao como o de PontosNoTriangulo: vertice em P, abertura de
+// 90 graus e lados com 1/4 da largura da nuvem (500)
+static TrianguloDeConsulta CampoDeVisaoEm(const Ponto &P, float a)
+{
+    float d = M_PI / 4;
+    return TrianguloDeConsulta(P, P + Ponto(cos(a + d), sin(a + d)) * 500,
+                               P + Ponto(cos(a - d), sin(a - d)) * 500);
+}
+
+static TrianguloDeConsulta CampoDeVisaoAleatorio()
+{
+    Ponto P(2000 * (rand() / (float)RAND_MAX) - 1000, 2000 * (rand() / (float)RAND_MAX) - 1000);
+    return CampoDeVisaoEm(P, 2 * M_PI * (rand() / (float)RAND_MAX));
+}
+
+// Nuvem das consultas: [-1000, 1000] nos dois eixos, como GeraNuvem
+static bool GeraNuvemDeConsulta(long n, const char *distribuicao, vector<Ponto> &Pontos)
+{
+    DistribuicaoDosPontos d;
+    if (!DistribuicaoPeloNome(distribuicao, d))
+    {
+        cout << "Distribuicao desconhecida: " << distribuicao << " (uniforme, agrupada, grade)" << endl;
+        return false;
+    }
+    GeradorDePontos(3, d).Gera(Pontos, n, Ponto(-1000, -1000), Ponto(1000, 1000));
+    return true;
+}
+
+static bool MesmoConjunto(vector<int> A, vector<int> B)
+{
+    sort(A.begin(), A.end());
+    sort(B.begin(), B.end());
+    return A == B;
+}
+
+static int BenchConsultas(int argc, char **argv)
+{
+    long nMin = (argc > 0) ? atol(argv[0]) : 1000;
+    long nMax = (argc > 1) ? atol(argv[1]) : 10000000;
+    int nConsultas = (argc > 2) ? atoi(argv[2]) : 1000;
+    const char *distribuicao = (argc > 3) ? argv[3] : "uniforme";
+    const int K = 16;
+    const float R = 50;
+
+    cout << setprecision(2) << fixed;
+    cout << "tempos por consulta em us; construcao em ms" << endl;
+    Temporizador T;
+    bool ok = true;
+    for (long n = nMin; n <= nMax; n *= 10)
+    {
+        vector<Ponto> Pontos;
+        if (!GeraNuvemDeConsulta(n, distribuicao, Pontos))
+            return 1;
+
+        QuadTreeDePontos Quad(16);
+        KdTreeDePontos Kd(8);
+        T.getDeltaT();
+        Quad.Constroi(Pontos);
+        double tQuad = T.getDeltaT();
+        Kd.Constroi(Pontos);
+        double tKd = T.getDeltaT();
+
+        // A forca bruta so roda nas primeiras consultas; as mesmas
+        // consultas conferem os resultados dos indices
+        int nBruta = (int)min((long)nConsultas, max(5L, 100000000L / n));
+        srand(5);
+        vector<TrianguloDeConsulta> Triangulos(nConsultas);
+        vector<Ponto> Centros(nConsultas);
+        for (int q = 0; q < nConsultas; q++)
+        {
+            Triangulos[q] = CampoDeVisaoAleatorio();
+            Centros[q] = Triangulos[q].V[0];
+        }
+
+        vector<vector<int>> Referencia(nBruta);
+        vector<int> R1;
+        double tempo[8];
+        long encontrados = 0;
+
+        vector<float> Xs(n), Ys(n);
+        for (long i = 0; i < n; i++)
+        {
+            Xs[i] = Pontos[i].x;
+            Ys[i] = Pontos[i].y;
+        }
+
+        // triangulo
+        T.getDeltaT();
+        for (int q = 0; q < nBruta; q++)
+            PontosNoTrianguloForcaBruta(Pontos, Triangulos[q], Referencia[q]);
+        tempo[0] = T.getDeltaT() / nBruta;
+        for (int q = 0; q < nConsultas; q++)
+        {
+            R1.clear();
+            AcrescentaPontosNoTriangulo(Xs.data(), Ys.data(), nullptr, (int)n, Triangulos[q], R1);
+            if (q < nBruta && R1 != Referencia[q])
+                ok = false;
+        }
+        tempo[7] = T.getDeltaT() / nConsultas;
+        for (int q = 0; q < nConsultas; q++)
+        {
+            Quad.PontosNoTriangulo(Triangulos[q], R1);
+            if (q < nBruta && !MesmoConjunto(R1, Referencia[q]))
+                ok = false;
+        }
+        tempo[1] = T.getDeltaT() / nConsultas;
+        for (int q = 0; q < nConsultas; q++)
+        {
+            Kd.PontosNoTriangulo(Triangulos[q], R1);
+            encontrados += R1.size();
+            if (q < nBruta && !MesmoConjunto(R1, Referencia[q]))
+                ok = false;
+        }
+        tempo[2] = T.getDeltaT() / nConsultas;
+
+        // k mais proximos do vertice do campo de visao
+        for (int q = 0; q < nBruta; q++)
+            MaisProximosForcaBruta(Pontos, Centros[q], K, Referencia[q]);
+        tempo[3] = T.getDeltaT() / nBruta;
+        for (int q = 0; q < nConsultas; q++)
+        {
+            Kd.MaisProximos(Centros[q], K, R1);
+            if (q < nBruta && R1 != Referencia[q])
+                ok = false;
+        }
+        tempo[4] = T.getDeltaT() / nConsultas;
+
+        // raio
+        for (int q = 0; q < nBruta; q++)
+            PontosNoRaioForcaBruta(Pontos, Centros[q], R, Referencia[q]);
+        tempo[5] = T.getDeltaT() / nBruta;
+        for (int q = 0; q < nConsultas; q++)
+        {
+            Kd.PontosNoRaio(Centros[q], R, R1);
+            if (q < nBruta && !MesmoConjunto(R1, Referencia[q]))
+                ok = false;
+        }
+        tempo[6] = T.getDeltaT() / nConsultas;
+
+        cout << "n=" << setw(8) << n << "  construcao: quad " << tQuad * 1000 << ", kd " << tKd * 1000
+             << "  (" << encontrados / nConsultas << " pontos por triangulo)" << endl;
+        cout << "    triangulo: bruta " << setw(10) << tempo[0] * 1e6 << "  varredura " << setw(9) << tempo[7] * 1e6
+             << "  quad " << setw(8) << tempo[1] * 1e6 << "  kd " << setw(8) << tempo[2] * 1e6 << endl;
+        cout << "    " << K << " vizinhos: bruta " << setw(9) << tempo[3] * 1e6
+             << "  kd " << setw(8) << tempo[4] * 1e6 << endl;
+        cout << "    raio " << R << ": bruta " << setw(9) << tempo[5] * 1e6
+             << "  kd " << setw(8) << tempo[6] * 1e6 << endl;
+    }
+    if (!ok)
+    {
+        cout << "ERRO: algum indice deu resultado diferente da forca bruta" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// **********************************************************************
+//  kernel
+// **********************************************************************
+// Como se faria com as rotinas de Ponto: tres chamadas a lado()
+static int ContaComLado(const vector<Ponto> &Pontos, const TrianguloDeConsulta &T)
+{
+    int dentro = 0;
+    for (size_t i = 0; i < Pontos.size(); i++)
+        if (lado(T.V[0], T.V[1], Pontos[i]) != DIREITA && lado(T.V[1], T.V[2], Pontos[i]) != DIREITA &&
+            lado(T.V[2], T.V[0], Pontos[i]) != DIREITA)
+            dentro++;
+    return dentro;
+}
+
+static int BenchKernel(int argc, char **argv)
+{
+    long nMin = (argc > 0) ? atol(argv[0]) : 1000;
+    long nMax = (argc > 1) ? atol(argv[1]) : 10000000;
+    KernelDoTriangulo Kernels[] = {KERNEL_ESCALAR, KERNEL_SSE2, KERNEL_AVX2};
+
+    cout << setprecision(1) << fixed;
+    cout << "milhoes de pontos por segundo" << endl;
+    Temporizador T;
+    bool ok = true;
+    for (long n = nMin; n <= nMax; n *= 10)
+    {
+        vector<Ponto> Pontos;
+        GeraNuvem(n, false, Pontos);
+        vector<float> Xs(n), Ys(n);
+        for (long i = 0; i < n; i++)
+        {
+            Xs[i] = Pontos[i].x;
+            Ys[i] = Pontos[i].y;
+        }
+        vector<int> Saida(n), Referencia;
+
+        // cerca de 10^8 pontos testados por variante
+        int nConsultas = (int)max(1L, 100000000L / n);
+        srand(6);
+        vector<TrianguloDeConsulta> Triangulos(nConsultas);
+        for (int q = 0; q < nConsultas; q++)
+            Triangulos[q] = CampoDeVisaoAleatorio();
+        double total = (double)n * nConsultas / 1e6;
+
+        cout << "n=" << setw(8) << n << ":";
+        long diferencasLado = 0;
+        T.getDeltaT();
+        for (int q = 0; q < nConsultas && q < 10; q++)
+        {
+            PontosNoTrianguloForcaBruta(Pontos, Triangulos[q], Referencia);
+            diferencasLado += labs(ContaComLado(Pontos, Triangulos[q]) - (long)Referencia.size());
+        }
+        T.getDeltaT();
+        for (int q = 0; q < nConsultas; q++)
+            ContaComLado(Pontos, Triangulos[q]);
+        cout << "  lado() " << total / T.getDeltaT();
+        for (int q = 0; q < nConsultas; q++)
+            PontosNoTrianguloForcaBruta(Pontos, Triangulos[q], Referencia);
+        cout << "  Ponto " << total / T.getDeltaT();
+
+        for (KernelDoTriangulo K : Kernels)
+        {
+            if (!KernelDisponivel(K))
+                continue;
+            T.getDeltaT();
+            for (int q = 0; q < nConsultas; q++)
+                FiltraPontosNoTriangulo(Xs.data(), Ys.data(), nullptr, (int)n, Triangulos[q], Saida.data(), K);
+            cout << "  " << NomeDoKernel(K) << " " << total / T.getDeltaT();
+
+            // confere a ultima consulta com a forca bruta
+            int m = FiltraPontosNoTriangulo(Xs.data(), Ys.data(), nullptr, (int)n, Triangulos[nConsultas - 1],
+                                            Saida.data(), K);
+            if (vector<int>(Saida.begin(), Saida.begin() + m) != Referencia)
+            {
+                cout << " (DIFERENTE)";
+                ok = false;
+            }
+        }
+        cout << "  [lado() difere em " << diferencasLado << " pontos]" << endl;
+    }
+    if (!ok)
+    {
+        cout << "ERRO: algum kernel deu resultado diferente da forca bruta" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// **********************************************************************
+//  incremental
+// **********************************************************************
+static int BenchIncremental(int argc, char **argv)
+{
+    long n = (argc > 0) ? atol(argv[0]) : 1000000;
+    int passos = (argc > 1) ? atoi(argv[1]) : 2000;
+    const char *distribuicao = (argc > 2) ? argv[2] : "uniforme";
+
+    vector<Ponto> Pontos;
+    if (!GeraNuvemDeConsulta(n, distribuicao, Pontos))
+        return 1;
+    QuadTreeDePontos Quad(16);
+    Quad.Constroi(Pontos);
+
+    // Caminho: gira 2 graus ou anda 8 unidades (2 numa janela de 500),
+    // voltando para o centro quando sai da nuvem
+    srand(7);
+    vector<TrianguloDeConsulta> Caminho(passos + 1);
+    Ponto P(0, 0);
+    float angulo = 0;
+    for (int q = 0; q <= passos; q++)
+    {
+        Caminho[q] = CampoDeVisaoEm(P, angulo * M_PI / 180);
+        int tecla = rand() % 4;
+        if (tecla == 0)
+            angulo += 2;
+        else if (tecla == 1)
+            angulo -= 2;
+        else
+        {
+            P = P + Ponto(cos(angulo * M_PI / 180), sin(angulo * M_PI / 180)) * 8;
+            if (fabs(P.x) > 900 || fabs(P.y) > 900)
+                angulo = atan2(-P.y, -P.x) * 180 / M_PI;
+        }
+    }
+
+    cout << setprecision(2) << fixed;
+    Temporizador T;
+    vector<int> Dentro;
+    ContadoresDaConsulta Completa, Incremental;
+    long encontrados = 0;
+    T.getDeltaT();
+    for (int q = 1; q <= passos; q++)
+    {
+        Quad.PontosNoTriangulo(Caminho[q], Dentro, &Completa);
+        encontrados += Dentro.size();
+    }
+    double tCompleta = T.getDeltaT() / passos;
+
+    // O que a consulta completa precisa para dar os mesmos eventos:
+    // comparar o conjunto novo com o anterior (marcas por indice)
+    vector<unsigned char> Marca(n, 0);
+    vector<int> Anterior, Entraram, Sairam;
+    Quad.PontosNoTriangulo(Caminho[0], Anterior);
+    for (int i : Anterior)
+        Marca[i] = 1;
+    T.getDeltaT();
+    for (int q = 1; q <= passos; q++)
+    {
+        Quad.PontosNoTriangulo(Caminho[q], Dentro);
+        Entraram.clear();
+        Sairam.clear();
+        for (int i : Dentro)
+        {
+            if (!Marca[i])
+                Entraram.push_back(i);
+            Marca[i] |= 2;
+        }
+        for (int i : Anterior)
+            if (!(Marca[i] & 2))
+            {
+                Sairam.push_back(i);
+                Marca[i] = 0;
+            }
+        for (int i : Dentro)
+            Marca[i] = 1;
+        Anterior.swap(Dentro);
+    }
+    double tComEventos = T.getDeltaT() / passos;
+
+    CampoDeVisaoIncremental Campo;
+    Campo.reinicia(Quad, Caminho[0]);
+    long eventos = 0;
+    Incremental.zera();
+    T.getDeltaT();
+    for (int q = 1; q <= passos; q++)
+    {
+        Campo.move(Quad, Caminho[q], &Incremental);
+        eventos += Campo.getEntraram().size() + Campo.getSairam().size();
+    }
+    double tIncremental = T.getDeltaT() / passos;
+
+    // Refaz o caminho conferindo o conjunto com a consulta completa
+    bool ok = true;
+    Campo.reinicia(Quad, Caminho[0]);
+    for (int q = 1; q <= passos && ok; q++)
+    {
+        Campo.move(Quad, Caminho[q]);
+        Quad.PontosNoTriangulo(Caminho[q], Dentro);
+        if (!MesmoConjunto(Campo.getDentro(), Dentro))
+        {
+            cout << "ERRO: conjunto incremental diferente no passo " << q << endl;
+            ok = false;
+        }
+    }
+
+    cout << "n=" << n << ", " << passos << " passos, " << encontrados / passos << " pontos dentro, "
+         << (double)eventos / passos << " eventos por passo" << endl;
+    cout << "  completa (sem eventos): " << setw(9) << tCompleta * 1e6 << " us  (" << Completa.NosVisitados / passos
+         << " nos, " << Completa.PontosTestados / passos << " testados, "
+         << Completa.PontosAceitosEmBloco / passos << " em bloco)" << endl;
+    cout << "  completa + eventos:      " << setw(9) << tComEventos * 1e6 << " us" << endl;
+    cout << "  incremental (eventos):   " << setw(9) << tIncremental * 1e6 << " us  (" << Incremental.NosVisitados / passos
+         << " nos, " << Incremental.PontosTestados / passos << " testados, "
+         << Incremental.PontosAceitosEmBloco / passos << " em bloco)" << endl;
+    return ok ? 0 : 1;
+}
+
+// **********************************************************************
+//  gera
+// **********************************************************************
+static long PosicoesRepetidas(vector<Ponto> P)
+{
+    sort(P.begin(), P.end(), [](const Ponto &A, const Ponto &B) { return A.x < B.x || (A.x == B.x && A.y < B.y); });
+    long repetidas = 0;
+    for (size_t i = 1; i < P.size(); i++)
+        if (P[i].x == P[i - 1].x && P[i].y == P[i - 1].y)
+            repetidas++;
+    return repetidas;
+}
+
+static int BenchGera(int argc, char **argv)
+{
+    long n = (argc > 0) ? atol(argv[0]) : 10000000;
+    int maxThreads = (argc > 1) ? atoi(argv[1]) : 0;
+    if (maxThreads <= 0)
+        maxThreads = GeradorDePontos().getNroDeThreads();
+    Ponto Min(0, 0), Max(500, 500);
+
+    cout << setprecision(1) << fixed;
+    Temporizador T;
+    vector<Ponto> Pontos(n), Referencia;
+
+    // Como o GeraPontos antigo de PontosNoTriangulo
+    srand(1);
+    T.getDeltaT();
+    for (long i = 0; i < n; i++)
+        Pontos[i] = Ponto((rand() % 1000) * 0.5f, (rand() % 1000) * 0.5f);
+    double t = T.getDeltaT();
+    cout << "rand() % 1000: " << n / t / 1e6 << " Mpontos/s, " << PosicoesRepetidas(Pontos)
+         << " posicoes repetidas" << endl;
+
+    bool ok = true;
+    for (int d = PONTOS_UNIFORMES; d <= PONTOS_EM_GRADE; d++)
+    {
+        GeradorDePontos G(1, (DistribuicaoDosPontos)d);
+        cout << setw(8) << NomeDaDistribuicao((DistribuicaoDosPontos)d) << ":";
+        for (int threads = 1;; threads = min(2 * threads, maxThreads))
+        {
+            G.setNroDeThreads(threads);
+            T.getDeltaT();
+            G.Gera(Pontos.data(), n, Min, Max);
+            t = T.getDeltaT();
+            cout << "  " << threads << "t " << n / t / 1e6 << " Mpontos/s";
+            if (threads == 1)
+                Referencia = Pontos;
+            else if (memcmp(Referencia.data(), Pontos.data(), n * sizeof(Ponto)) != 0)
+            {
+                cout << " (DIFERENTE)";
+                ok = false;
+            }
+            if (threads == maxThreads)
+                break;
+        }
+        long fora = 0;
+        for (long i = 0; i < n; i++)
+            if (Pontos[i].x < Min.x || Pontos[i].x > Max.x || Pontos[i].y < Min.y || Pontos[i].y > Max.y)
+                fora++;
+        cout << ", " << PosicoesRepetidas(Pontos) << " posicoes repetidas";
+        if (fora > 0)
+        {
+            cout << ", " << fora << " FORA DA CAIXA";
+            ok = false;
+        }
+        cout << endl;
+    }
+    if (!ok)
+    {
+        cout << "ERRO: resultado depende do numero de threads ou saiu da caixa" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// **********************************************************************
+struct TesteDeDesempenho
+{
+    const char *Nome;
+    int (*Executa)(int argc, char **argv);
+};
+
+static TesteDeDesempenho Testes[] = {
+    {"leitura", BenchLeitura},
+    {"faixas", BenchFaixas},
+    {"classifica", BenchClassifica},
+    {"hull", BenchHull},
+    {"triangula", BenchTriangula},
+    {"consultas", BenchConsultas},
+    {"kernel", BenchKernel},
+    {"incremental", BenchIncremental},
+    {"gera", BenchGera},
+};
+
+int main(int argc, char **argv)
+{
+    int nTestes = sizeof(Testes) / sizeof(Testes[0]);
+    if (argc >= 2)
+        for (int i = 0; i < nTestes; i++)
+            if (strcmp(argv[1], Testes[i].Nome) == 0)
+                return Testes[i].Executa(argc - 2, argv + 2);
+
+    cout << "Uso: " << argv[0] << " <teste> [parametros]" << endl << "Testes:";
+    for (int i = 0; i < nTestes; i++)
+        cout << " " << Testes[i].Nome;
+    cout << endl;
+    return 1;
+}
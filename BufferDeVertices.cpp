@@ -0,0 +1,257 @@
+//
+//  BufferDeVertices.cpp
+//  OpenGLTest
+//
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <algorithm>
+using namespace std;
+
+#include "BufferDeVertices.h"
+
+#ifdef WIN32
+#include <freeglut_ext.h>
+#endif
+#ifdef __linux__
+#include <GL/freeglut_ext.h>
+#endif
+
+// Os vertices sao enviados direto do vector<Ponto>, com stride sizeof(Ponto)
+static_assert(sizeof(Ponto) == 3 * sizeof(float), "Ponto deve ter so x, y, z");
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+#ifndef GL_ELEMENT_ARRAY_BUFFER
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#endif
+#ifndef GL_DYNAMIC_DRAW
+#define GL_DYNAMIC_DRAW 0x88E8
+#endif
+
+// **********************************************************************
+//  Funcoes do OpenGL 1.5. No macOS fazem parte do framework; nos outros
+//  sistemas sao obtidas em tempo de execucao (o opengl32 do Windows so
+//  exporta o OpenGL 1.1).
+// **********************************************************************
+#ifdef __APPLE__
+static bool CarregaFuncoes()
+{
+    return true;
+}
+#else
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+typedef void (APIENTRY *FuncGenBuffers)(GLsizei, GLuint *);
+typedef void (APIENTRY *FuncDeleteBuffers)(GLsizei, const GLuint *);
+typedef void (APIENTRY *FuncBindBuffer)(GLenum, GLuint);
+typedef void (APIENTRY *FuncBufferData)(GLenum, ptrdiff_t, const void *, GLenum);
+typedef void (APIENTRY *FuncBufferSubData)(GLenum, ptrdiff_t, ptrdiff_t, const void *);
+
+static FuncGenBuffers glGenBuffers_ = NULL;
+static FuncDeleteBuffers glDeleteBuffers_ = NULL;
+static FuncBindBuffer glBindBuffer_ = NULL;
+static FuncBufferData glBufferData_ = NULL;
+static FuncBufferSubData glBufferSubData_ = NULL;
+
+#define glGenBuffers glGenBuffers_
+#define glDeleteBuffers glDeleteBuffers_
+#define glBindBuffer glBindBuffer_
+#define glBufferData glBufferData_
+#define glBufferSubData glBufferSubData_
+
+// Tenta o nome do OpenGL 1.5 e o da extensao ARB
+static void *ObtemFuncao(const char *nome)
+{
+    void *f = (void *)glutGetProcAddress(nome);
+    if (f == NULL)
+    {
+        string arb = string(nome) + "ARB";
+        f = (void *)glutGetProcAddress(arb.c_str());
+    }
+    return f;
+}
+
+static bool CarregaFuncoes()
+{
+    static int carregadas = -1; // -1: ainda nao tentou
+    if (carregadas < 0)
+    {
+        glGenBuffers_ = (FuncGenBuffers)ObtemFuncao("glGenBuffers");
+        glDeleteBuffers_ = (FuncDeleteBuffers)ObtemFuncao("glDeleteBuffers");
+        glBindBuffer_ = (FuncBindBuffer)ObtemFuncao("glBindBuffer");
+        glBufferData_ = (FuncBufferData)ObtemFuncao("glBufferData");
+        glBufferSubData_ = (FuncBufferSubData)ObtemFuncao("glBufferSubData");
+        carregadas = glGenBuffers_ && glDeleteBuffers_ && glBindBuffer_ &&
+                     glBufferData_ && glBufferSubData_;
+    }
+    return carregadas == 1;
+}
+#endif
+
+bool BufferDeVertices::Suportado()
+{
+    static int suportado = -1;
+    if (suportado < 0)
+    {
+        // glGetString so responde com um contexto ativo
+        const char *versao = (const char *)glGetString(GL_VERSION);
+        const char *ext = (const char *)glGetString(GL_EXTENSIONS);
+        if (versao == NULL)
+            return false;
+        bool temVBO = (versao[0] > '1' || (versao[0] == '1' && versao[2] >= '5')) ||
+                      (ext != NULL && strstr(ext, "GL_ARB_vertex_buffer_object") != NULL);
+        suportado = temVBO && CarregaFuncoes();
+    }
+    return suportado == 1;
+}
+
+// **********************************************************************
+BufferDeVertices::BufferDeVertices()
+{
+    Id = 0;
+    Capacidade = 0;
+    SujoInicio = SujoFim = 0;
+    ArraysLigados = false;
+}
+
+BufferDeVertices::BufferDeVertices(const BufferDeVertices &)
+{
+    Id = 0;
+    Capacidade = 0;
+    SujoInicio = SujoFim = 0;
+    ArraysLigados = false;
+}
+
+BufferDeVertices &BufferDeVertices::operator=(const BufferDeVertices &)
+{
+    // Mantem o proprio buffer; o conteudo todo passa a estar desatualizado
+    marcaTudoSujo();
+    return *this;
+}
+
+BufferDeVertices::~BufferDeVertices()
+{
+    if (Id != 0)
+        glDeleteBuffers(1, &Id);
+}
+
+void BufferDeVertices::marcaSujo(size_t inicio, size_t fim)
+{
+    if (inicio >= fim)
+        return;
+    if (SujoInicio >= SujoFim)
+    {
+        SujoInicio = inicio;
+        SujoFim = fim;
+    }
+    else
+    {
+        SujoInicio = min(SujoInicio, inicio);
+        SujoFim = max(SujoFim, fim);
+    }
+}
+
+void BufferDeVertices::marcaTudoSujo()
+{
+    SujoInicio = 0;
+    SujoFim = (size_t)-1;
+}
+
+void BufferDeVertices::ativa(const vector<Ponto> &V)
+{
+    glEnableClientState(GL_VERTEX_ARRAY);
+    ArraysLigados = true;
+    if (!Suportado())
+    {
+        if (!V.empty())
+            glVertexPointer(3, GL_FLOAT, sizeof(Ponto), &V[0]);
+        return;
+    }
+
+    if (Id == 0)
+        glGenBuffers(1, &Id);
+    glBindBuffer(GL_ARRAY_BUFFER, Id);
+    if (V.size() > Capacidade)
+    {
+        // Cresce com folga para que insercoes seguidas nao realoquem
+        Capacidade = max(V.size(), Capacidade * 2);
+        glBufferData(GL_ARRAY_BUFFER, Capacidade * sizeof(Ponto), NULL, GL_DYNAMIC_DRAW);
+        SujoInicio = 0;
+        SujoFim = V.size();
+    }
+    SujoFim = min(SujoFim, V.size());
+    if (SujoInicio < SujoFim)
+        glBufferSubData(GL_ARRAY_BUFFER, SujoInicio * sizeof(Ponto),
+                        (SujoFim - SujoInicio) * sizeof(Ponto), &V[SujoInicio]);
+    SujoInicio = SujoFim = 0;
+    glVertexPointer(3, GL_FLOAT, sizeof(Ponto), (const void *)0);
+}
+
+void BufferDeVertices::desativa()
+{
+    if (!ArraysLigados)
+        return;
+    if (Id != 0)
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    ArraysLigados = false;
+}
+
+// **********************************************************************
+BufferDeIndices::BufferDeIndices()
+{
+    Id = 0;
+    Capacidade = 0;
+    Sujo = true;
+}
+
+BufferDeIndices::BufferDeIndices(const BufferDeIndices &)
+{
+    Id = 0;
+    Capacidade = 0;
+    Sujo = true;
+}
+
+BufferDeIndices &BufferDeIndices::operator=(const BufferDeIndices &)
+{
+    Sujo = true;
+    return *this;
+}
+
+BufferDeIndices::~BufferDeIndices()
+{
+    if (Id != 0)
+        glDeleteBuffers(1, &Id);
+}
+
+const void *BufferDeIndices::ativa(const vector<unsigned> &I)
+{
+    if (!BufferDeVertices::Suportado())
+        return I.empty() ? NULL : &I[0];
+
+    if (Id == 0)
+        glGenBuffers(1, &Id);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, Id);
+    if (Sujo && !I.empty())
+    {
+        if (I.size() > Capacidade)
+        {
+            Capacidade = I.size();
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, Capacidade * sizeof(unsigned), &I[0], GL_DYNAMIC_DRAW);
+        }
+        else
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, I.size() * sizeof(unsigned), &I[0]);
+    }
+    Sujo = false;
+    return (const void *)0;
+}
+
+void BufferDeIndices::desativa()
+{
+    if (Id != 0)
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,86 @@
+//
+//  BufferDeVertices.h
+//  OpenGLTest
+//
+//  Copia, na memoria da placa de video (vertex buffer object), do
+//  vetor de vertices de um Poligono. O vetor eh enviado uma vez; depois
+//  so os trechos marcados como alterados sao reenviados:
+//
+//      Buffer.marcaSujo(i, i+1);        // depois de alterar V[i]
+//      ...
+//      Buffer.ativa(V);                 // reenvia o que mudou
+//      glDrawArrays(GL_LINE_LOOP, 0, V.size());
+//      Buffer.desativa();
+//
+//  Sem suporte a VBO (OpenGL < 1.5), ativa() aponta os vertex arrays
+//  direto para o vetor na memoria, o que ainda desenha com uma unica
+//  chamada.
+//
+
+#ifndef BufferDeVertices_hpp
+#define BufferDeVertices_hpp
+
+#include <vector>
+using namespace std;
+
+#ifdef WIN32
+#include <windows.h>
+#include <glut.h>
+#endif
+
+#ifdef __APPLE__
+#include <GLUT/glut.h>
+#endif
+
+#ifdef __linux__
+#include <GL/glut.h>
+#endif
+
+#include "Ponto.h"
+
+class BufferDeVertices
+{
+    GLuint Id;
+    size_t Capacidade;            // em vertices
+    size_t SujoInicio, SujoFim;   // trecho a reenviar: [SujoInicio, SujoFim)
+    bool ArraysLigados;
+public:
+    BufferDeVertices();
+    // Uma copia nao compartilha o buffer: cria o seu no primeiro desenho
+    BufferDeVertices(const BufferDeVertices &);
+    BufferDeVertices &operator=(const BufferDeVertices &);
+    ~BufferDeVertices();
+
+    void marcaSujo(size_t inicio, size_t fim);
+    void marcaTudoSujo();
+
+    // Atualiza o buffer com V e liga o vertex array (posicoes)
+    void ativa(const vector<Ponto> &V);
+    void desativa();
+
+    // Ha VBO neste contexto? (so pode ser chamado com contexto ativo)
+    static bool Suportado();
+};
+
+// Indices (por exemplo, de triangulos) na placa de video. Eh sempre
+// reenviado inteiro quando marcado como alterado.
+class BufferDeIndices
+{
+    GLuint Id;
+    size_t Capacidade;
+    bool Sujo;
+public:
+    BufferDeIndices();
+    BufferDeIndices(const BufferDeIndices &);
+    BufferDeIndices &operator=(const BufferDeIndices &);
+    ~BufferDeIndices();
+
+    void marcaSujo() { Sujo = true; }
+
+    // Atualiza e liga o buffer; retorna o ponteiro a passar para o
+    // glDrawElements (um deslocamento, se houver VBO)
+    const void *ativa(const vector<unsigned> &I);
+    void desativa();
+};
+
+#endif /* BufferDeVertices_hpp */
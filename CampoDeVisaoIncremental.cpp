@@ -0,0 +1,65 @@
+//
+//  CampoDeVisaoIncremental.cpp
+//  OpenGLTest
+//
+
+#include "CampoDeVisaoIncremental.h"
+
+void CampoDeVisaoIncremental::reinicia(const QuadTreeDePontos &Q, const TrianguloDeConsulta &T,
+                                       ContadoresDaConsulta *Contadores)
+{
+    int n = Q.getNroDePontos();
+    vector<int> Indices;
+    Q.PontosNoTriangulo(T, Indices, Contadores);
+    vector<unsigned char> Marca(n, 0);
+    for (int i : Indices)
+        Marca[i] = 1;
+
+    Dentro.clear();
+    NaArvore.clear();
+    Posicao.assign(n, -1);
+    for (int k = 0; k < n; k++)
+        if (Marca[Q.getIndice(k)])
+            insere(Q, k);
+    Entraram = Dentro;
+    Sairam.clear();
+    Triangulo = T;
+}
+
+void CampoDeVisaoIncremental::insere(const QuadTreeDePontos &Q, int k)
+{
+    Posicao[k] = (int)Dentro.size();
+    NaArvore.push_back(k);
+    Dentro.push_back(Q.getIndice(k));
+}
+
+// Troca com o ultimo, para nao deslocar os vetores
+void CampoDeVisaoIncremental::retira(int k)
+{
+    int p = Posicao[k];
+    int ultimo = NaArvore.back();
+    NaArvore[p] = ultimo;
+    Dentro[p] = Dentro.back();
+    Posicao[ultimo] = p;
+    NaArvore.pop_back();
+    Dentro.pop_back();
+    Posicao[k] = -1;
+}
+
+void CampoDeVisaoIncremental::move(const QuadTreeDePontos &Q, const TrianguloDeConsulta &T,
+                                   ContadoresDaConsulta *Contadores)
+{
+    Q.PontosQueMudaram(Triangulo, T, Entraram, Sairam, Contadores);
+    Triangulo = T;
+
+    for (int &k : Sairam)
+    {
+        retira(k);
+        k = Q.getIndice(k);
+    }
+    for (int &k : Entraram)
+    {
+        insere(Q, k);
+        k = Q.getIndice(k);
+    }
+}
@@ -0,0 +1,64 @@
+//
+//  CampoDeVisaoIncremental.h
+//  OpenGLTest
+//
+//  Conjunto de pontos dentro do campo de visao mantido de um quadro
+//  para o outro, com os eventos de cada passo: os pontos que entraram
+//  e os que sairam. Cada passo das setas move o triangulo 2 unidades ou
+//  gira 2 graus, entao so os nos da quadtree que tocam a diferenca
+//  simetrica entre os dois triangulos sao examinados
+//  (QuadTreeDePontos::PontosQueMudaram), e o trabalho depende so dessa
+//  diferenca, nao do tamanho do conjunto.
+//
+//  Nao eh mais rapido que refazer a consulta: a diferenca simetrica de
+//  dois passos seguidos eh uma faixa ao longo das tres arestas, mais
+//  fina que uma folha, e visita as mesmas folhas da borda que a
+//  consulta completa (que aceita o interior em bloco). O que se ganha
+//  sao os eventos, que a consulta completa so daria comparando o
+//  conjunto novo com o anterior ("Benchmark incremental").
+//
+//  O conjunto eh guardado pela posicao dos pontos na ordem da arvore,
+//  e nao pelo indice original: os eventos de um passo vem de poucas
+//  folhas vizinhas e caem em trechos proximos da memoria.
+//
+//      CampoDeVisaoIncremental Campo;
+//      Campo.reinicia(QuadTree, T0);
+//      Campo.move(QuadTree, T1);   // getEntraram(), getSairam()
+//
+
+#ifndef CampoDeVisaoIncremental_hpp
+#define CampoDeVisaoIncremental_hpp
+
+#include <vector>
+using namespace std;
+
+#include "TrianguloDeConsulta.h"
+#include "QuadTreeDePontos.h"
+
+class CampoDeVisaoIncremental
+{
+    TrianguloDeConsulta Triangulo; // triangulo do conjunto atual
+    vector<int> Dentro;            // indices dos pontos dentro, sem ordem
+    vector<int> NaArvore;          // os mesmos pontos, como posicoes na arvore
+    vector<int> Posicao;           // por posicao na arvore: lugar em Dentro; -1 se fora
+    vector<int> Entraram, Sairam;  // eventos do ultimo passo
+
+    void insere(const QuadTreeDePontos &Q, int k);
+    void retira(int k);
+public:
+    // Consulta completa; necessaria no inicio e sempre que a arvore for
+    // reconstruida
+    void reinicia(const QuadTreeDePontos &Q, const TrianguloDeConsulta &T,
+                  ContadoresDaConsulta *Contadores = nullptr);
+
+    // Passa para o triangulo T, atualizando o conjunto e os eventos.
+    // A arvore tem que ser a mesma do ultimo reinicia.
+    void move(const QuadTreeDePontos &Q, const TrianguloDeConsulta &T,
+              ContadoresDaConsulta *Contadores = nullptr);
+
+    const vector<int> &getDentro() const { return Dentro; }
+    const vector<int> &getEntraram() const { return Entraram; }
+    const vector<int> &getSairam() const { return Sairam; }
+};
+
+#endif /* CampoDeVisaoIncremental_hpp */
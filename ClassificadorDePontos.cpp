@@ -0,0 +1,61 @@
+//
+//  ClassificadorDePontos.cpp
+//  OpenGLTest
+//
+
+#include <vector>
+#include <cmath>
+using namespace std;
+
+#include "ClassificadorDePontos.h"
+#include "DivisaoEmBlocos.h"
+
+// Minimo de pontos por bloco em NroDeBlocos
+static const long PONTOS_POR_THREAD_MIN = 16384;
+
+ClassificadorDePontos::ClassificadorDePontos()
+{
+    NroDeThreads = 0;
+    Tolerancia = 0;
+}
+
+void ClassificadorDePontos::Constroi(Poligono &P, int qtdDeFaixas, float tolerancia)
+{
+    Faixas.Constroi(P, qtdDeFaixas);
+    if (tolerancia < 0)
+    {
+        tolerancia = 0;
+        if (P.getNVertices() > 0)
+        {
+            Ponto Min, Max;
+            P.obtemLimites(Min, Max);
+            tolerancia = 1e-6f * sqrt((Max.x - Min.x) * (Max.x - Min.x) + (Max.y - Min.y) * (Max.y - Min.y));
+        }
+    }
+    Tolerancia = tolerancia;
+}
+
+void ClassificadorDePontos::setNroDeThreads(int n)
+{
+    NroDeThreads = max(0, n);
+}
+
+int ClassificadorDePontos::getNroDeThreads() const
+{
+    return ThreadsDisponiveis(NroDeThreads);
+}
+
+static void ClassificaIntervalo(const ConjuntoDeFaixas *Faixas, float tol,
+                                const Ponto *Pontos, long inicio, long fim, unsigned char *Resultado)
+{
+    for (long i = inicio; i < fim; i++)
+        Resultado[i] = (unsigned char)Faixas->ClassificaPonto(Pontos[i], tol);
+}
+
+void ClassificadorDePontos::Classifica(const Ponto *Pontos, long n, unsigned char *Resultado) const
+{
+    const ConjuntoDeFaixas *F = &Faixas;
+    float tol = Tolerancia;
+    ExecutaEmBlocos(n, NroDeBlocos(n, getNroDeThreads(), PONTOS_POR_THREAD_MIN),
+                    [=](int, long inicio, long fim) { ClassificaIntervalo(F, tol, Pontos, inicio, fim, Resultado); });
+}
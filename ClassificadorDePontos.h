@@ -0,0 +1,43 @@
+//
+//  ClassificadorDePontos.h
+//  OpenGLTest
+//
+//  Classificacao em lote de pontos contra um poligono (dentro, fora
+//  ou na borda), dividindo o vetor de pontos entre varias threads.
+//  Cada consulta usa o indice de faixas (ConjuntoDeFaixas), que eh
+//  somente leitura depois de construido e pode ser compartilhado.
+//
+//      ClassificadorDePontos C;
+//      C.Constroi(Mapa);
+//      C.setNroDeThreads(8);
+//      C.Classifica(Pontos, n, Resultado);   // Resultado[i]: PosicaoDoPonto
+//
+
+#ifndef ClassificadorDePontos_hpp
+#define ClassificadorDePontos_hpp
+
+#include "ConjuntoDeFaixas.h"
+
+class ClassificadorDePontos
+{
+    ConjuntoDeFaixas Faixas;
+    int NroDeThreads;
+    float Tolerancia;
+public:
+    ClassificadorDePontos();
+
+    // Constroi o indice. Com tolerancia < 0 usa 1e-6 da diagonal da
+    // caixa envolvente do poligono.
+    void Constroi(Poligono &P, int qtdDeFaixas = 0, float tolerancia = -1);
+
+    // 0: uma thread por nucleo
+    void setNroDeThreads(int n);
+    int getNroDeThreads() const;
+    float getTolerancia() const { return Tolerancia; }
+    const ConjuntoDeFaixas &getFaixas() const { return Faixas; }
+
+    // Resultado[i] recebe a PosicaoDoPonto de Pontos[i]
+    void Classifica(const Ponto *Pontos, long n, unsigned char *Resultado) const;
+};
+
+#endif /* ClassificadorDePontos_hpp */
@@ -0,0 +1,47 @@
+//
+//  Colisao.cpp
+//  OpenGLTest
+//
+
+#include "Colisao.h"
+#include "AABB.h"
+
+// Projeta os quatro cantos de E sobre o eixo (ex,ey)
+static inline void Projeta(const Ponto E[4], float ex, float ey, float &mn, float &mx)
+{
+    mn = mx = E[0].x * ex + E[0].y * ey;
+    for (int i = 1; i < 4; i++)
+    {
+        float p = E[i].x * ex + E[i].y * ey;
+        if (p < mn) mn = p;
+        else if (p > mx) mx = p;
+    }
+}
+
+// Os eixos candidatos de um retangulo sao as direcoes de duas arestas
+// vizinhas. Nao eh preciso normalizar: so o sinal da sobreposicao importa.
+static bool SeparaNosEixosDe(const Ponto E[4], const Ponto A[4], const Ponto B[4])
+{
+    for (int k = 0; k < 2; k++)
+    {
+        float ex = E[k + 1].x - E[k].x;
+        float ey = E[k + 1].y - E[k].y;
+        float minA, maxA, minB, maxB;
+        Projeta(A, ex, ey, minA, maxA);
+        Projeta(B, ex, ey, minB, maxB);
+        if (maxA < minB || maxB < minA)
+            return true;
+    }
+    return false;
+}
+
+bool ColisaoOBB(const Ponto A[4], const Ponto B[4])
+{
+    if (!AABB::DosPontos(A, 4).intersecta(AABB::DosPontos(B, 4)))
+        return false;
+    if (SeparaNosEixosDe(A, A, B))
+        return false;
+    if (SeparaNosEixosDe(B, A, B))
+        return false;
+    return true;
+}
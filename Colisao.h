@@ -0,0 +1,23 @@
+//
+//  Colisao.h
+//  OpenGLTest
+//
+//  Teste de colisao entre dois envelopes orientados (OBB) pelo
+//  teorema dos eixos separadores (SAT).
+//
+//  O envelope eh dado pelos seus quatro cantos em sequencia, como em
+//  CompEnvelope::Canto. Antes do SAT eh feito um teste rapido com as
+//  caixas alinhadas aos eixos (AABB).
+//  Ao contrario do teste aresta x aresta, tambem detecta o caso em que
+//  um envelope esta inteiramente dentro do outro.
+//
+
+#ifndef Colisao_hpp
+#define Colisao_hpp
+
+#include "Ponto.h"
+
+// Retorna true se os envelopes A e B se tocam ou se sobrepoem
+bool ColisaoOBB(const Ponto A[4], const Ponto B[4]);
+
+#endif /* Colisao_hpp */
@@ -0,0 +1,200 @@
+//
+//  ConjuntoDeFaixas.cpp
+//  OpenGLTest
+//
+
+#include <algorithm>
+#include "ConjuntoDeFaixas.h"
+
+// Media de arestas por faixa usada quando a quantidade eh automatica
+static const int ARESTAS_POR_FAIXA = 4;
+
+// O raio que sai de Q para a esquerda cruza a aresta A?
+static inline bool CruzaRaio(const ArestaNaFaixa &A, float qx, float qy)
+{
+    if (qy < A.Y1 || qy >= A.Y2)
+        return false;
+    // Q a direita da aresta orientada para cima <=> a interseccao
+    // esta a esquerda de Q
+    double v = (double)(A.X2 - A.X1) * (qy - A.Y1) - (double)(qx - A.X1) * (A.Y2 - A.Y1);
+    return v < 0;
+}
+
+// Q esta a menos de "tol" da aresta A?
+static inline bool PertoDaAresta(const ArestaNaFaixa &A, float qx, float qy, float tol)
+{
+    if (qy < A.Y1 - tol || qy > A.Y2 + tol)
+        return false;
+    if (qx < min(A.X1, A.X2) - tol || qx > max(A.X1, A.X2) + tol)
+        return false;
+    double dx = A.X2 - A.X1, dy = A.Y2 - A.Y1;
+    double px = qx - A.X1, py = qy - A.Y1;
+    double comp2 = dx * dx + dy * dy;
+    double t = (comp2 > 0) ? (px * dx + py * dy) / comp2 : 0;
+    t = max(0.0, min(1.0, t));
+    double ex = px - t * dx, ey = py - t * dy;
+    return ex * ex + ey * ey <= (double)tol * tol;
+}
+
+static ArestaNaFaixa MontaAresta(int a, Ponto P1, Ponto P2)
+{
+    ArestaNaFaixa A;
+    if (P1.y > P2.y)
+        swap(P1, P2);
+    A.X1 = P1.x; A.Y1 = P1.y;
+    A.X2 = P2.x; A.Y2 = P2.y;
+    A.Aresta = a;
+    return A;
+}
+
+// **********************************************************************
+void Faixa::CadastraAresta(int a, Ponto P1, Ponto P2)
+{
+    ArestasNaFaixa.push_back(MontaAresta(a, P1, P2));
+}
+
+// **********************************************************************
+ConjuntoDeFaixas::ConjuntoDeFaixas()
+{
+    YMin = YMax = 0;
+    AlturaDaFaixa = 1;
+}
+
+void ConjuntoDeFaixas::CriaFaixas(int qtdDeFaixas)
+{
+    TodasAsFaixas.clear();
+    TodasAsFaixas.resize(qtdDeFaixas);
+}
+
+void ConjuntoDeFaixas::CadastraArestaNaFaixa(int f, int a, Ponto P1, Ponto P2)
+{
+    TodasAsFaixas[f].CadastraAresta(a, P1, P2);
+}
+
+int ConjuntoDeFaixas::CalculaFaixa(float y) const
+{
+    int n = (int)TodasAsFaixas.size();
+    if (n == 0 || y < YMin || y > YMax)
+        return -1;
+    // YMin + AlturaDaFaixa * n pode ficar abaixo de YMax por
+    // arredondamento; o que passar da ultima faixa eh dela
+    return min(n - 1, (int)((y - YMin) / AlturaDaFaixa));
+}
+
+void ConjuntoDeFaixas::Constroi(Poligono &P, int qtdDeFaixas)
+{
+    int nArestas = (int)P.getNVertices();
+    if (qtdDeFaixas <= 0)
+        qtdDeFaixas = max(1, nArestas / ARESTAS_POR_FAIXA);
+    CriaFaixas(qtdDeFaixas);
+    if (nArestas == 0)
+        return;
+
+    Ponto Min, Max;
+    P.obtemLimites(Min, Max);
+    YMin = Min.y;
+    YMax = Max.y;
+    AlturaDaFaixa = (Max.y - Min.y) / qtdDeFaixas;
+    if (AlturaDaFaixa <= 0)
+        AlturaDaFaixa = 1;
+
+    for (int a = 0; a < nArestas; a++)
+    {
+        Ponto P1, P2;
+        P.getAresta(a, P1, P2);
+        int f1 = CalculaFaixa(min(P1.y, P2.y));
+        int f2 = CalculaFaixa(max(P1.y, P2.y));
+        for (int f = f1; f <= f2; f++)
+            CadastraArestaNaFaixa(f, a, P1, P2);
+    }
+}
+
+int ConjuntoDeFaixas::ContaCruzamentos(Ponto P) const
+{
+    int f = CalculaFaixa(P.y);
+    if (f < 0)
+        return 0;
+    const Faixa &F = TodasAsFaixas[f];
+    int cont = 0;
+    for (int i = 0; i < F.getNroDeArestas(); i++)
+        if (CruzaRaio(F.getArestaNaFaixa(i), P.x, P.y))
+            cont++;
+    return cont;
+}
+
+int ConjuntoDeFaixas::ArestasCruzadas(Ponto P, vector<int> &arestas) const
+{
+    arestas.clear();
+    int f = CalculaFaixa(P.y);
+    if (f < 0)
+        return 0;
+    const Faixa &F = TodasAsFaixas[f];
+    for (int i = 0; i < F.getNroDeArestas(); i++)
+        if (CruzaRaio(F.getArestaNaFaixa(i), P.x, P.y))
+            arestas.push_back(F.getAresta(i));
+    return (int)arestas.size();
+}
+
+bool ConjuntoDeFaixas::IntervaloDeFaixas(float y1, float y2, int &f1, int &f2) const
+{
+    int n = (int)TodasAsFaixas.size();
+    if (n == 0 || y2 < YMin || y1 > YMax)
+        return false;
+    f1 = max(0, (int)((y1 - YMin) / AlturaDaFaixa));
+    f2 = min(n - 1, (int)((y2 - YMin) / AlturaDaFaixa));
+    return f1 <= f2;
+}
+
+PosicaoDoPonto ConjuntoDeFaixas::ClassificaPonto(Ponto P, float tolerancia) const
+{
+    // Uma aresta a menos de "tolerancia" do ponto pode estar numa
+    // faixa vizinha, se o ponto estiver perto da divisa
+    int f1, f2;
+    if (tolerancia > 0 && IntervaloDeFaixas(P.y - tolerancia, P.y + tolerancia, f1, f2))
+        for (int f = f1; f <= f2; f++)
+        {
+            const Faixa &F = TodasAsFaixas[f];
+            for (int i = 0; i < F.getNroDeArestas(); i++)
+                if (PertoDaAresta(F.getArestaNaFaixa(i), P.x, P.y, tolerancia))
+                    return PONTO_NA_BORDA;
+        }
+    return (ContaCruzamentos(P) & 1) ? PONTO_DENTRO : PONTO_FORA;
+}
+
+long ConjuntoDeFaixas::getNroDeCadastros() const
+{
+    long total = 0;
+    for (size_t f = 0; f < TodasAsFaixas.size(); f++)
+        total += TodasAsFaixas[f].getNroDeArestas();
+    return total;
+}
+
+// **********************************************************************
+PosicaoDoPonto ClassificaPontoForcaBruta(Poligono &P, Ponto Q, float tolerancia)
+{
+    int cont = 0;
+    for (int a = 0; a < (int)P.getNVertices(); a++)
+    {
+        Ponto P1, P2;
+        P.getAresta(a, P1, P2);
+        ArestaNaFaixa A = MontaAresta(a, P1, P2);
+        if (tolerancia > 0 && PertoDaAresta(A, Q.x, Q.y, tolerancia))
+            return PONTO_NA_BORDA;
+        if (CruzaRaio(A, Q.x, Q.y))
+            cont++;
+    }
+    return (cont & 1) ? PONTO_DENTRO : PONTO_FORA;
+}
+
+int ContaCruzamentosForcaBruta(Poligono &P, Ponto Q)
+{
+    int cont = 0;
+    for (int a = 0; a < (int)P.getNVertices(); a++)
+    {
+        Ponto P1, P2;
+        P.getAresta(a, P1, P2);
+        if (CruzaRaio(MontaAresta(a, P1, P2), Q.x, Q.y))
+            cont++;
+    }
+    return cont;
+}
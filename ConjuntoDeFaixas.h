@@ -0,0 +1,118 @@
+//
+//  ConjuntoDeFaixas.h
+//  OpenGLTest
+//
+//  Indice de faixas horizontais para testar se um ponto esta dentro
+//  de um poligono. O intervalo Y do poligono eh dividido em N faixas
+//  de mesma altura e cada aresta eh cadastrada em todas as faixas que
+//  ela atravessa. Uma consulta calcula a faixa do ponto e testa so as
+//  arestas dessa faixa:
+//
+//      ConjuntoDeFaixas Faixas;
+//      Faixas.Constroi(Mapa, 0);       // 0: quantidade automatica
+//      if (Faixas.PontoDentro(P)) ...
+//
+//  O teste usa a regra do numero de cruzamentos com um raio que sai
+//  do ponto para a esquerda (-x). Uma aresta conta se
+//  min(y1,y2) <= P.y < max(y1,y2), entao arestas horizontais nunca
+//  contam e um vertice no raio eh contado uma vez so.
+//
+
+#ifndef ConjuntoDeFaixas_hpp
+#define ConjuntoDeFaixas_hpp
+
+#include <vector>
+using namespace std;
+
+#include "Ponto.h"
+#include "Poligono.h"
+
+// Resultado da classificacao de um ponto
+enum PosicaoDoPonto
+{
+    PONTO_FORA = 0,
+    PONTO_DENTRO = 1,
+    PONTO_NA_BORDA = 2
+};
+
+// Aresta guardada dentro da faixa, ja com Y1 <= Y2
+struct ArestaNaFaixa
+{
+    float X1, Y1, X2, Y2;
+    int Aresta; // indice da aresta no poligono
+};
+
+class Faixa{
+    vector<ArestaNaFaixa> ArestasNaFaixa;
+public:
+    void CadastraAresta(int a, Ponto P1, Ponto P2);
+    int getNroDeArestas() const
+    {
+        return (int)ArestasNaFaixa.size();
+    }
+    int getAresta(int i) const
+    {
+        return ArestasNaFaixa[i].Aresta;
+    }
+    const ArestaNaFaixa &getArestaNaFaixa(int i) const
+    {
+        return ArestasNaFaixa[i];
+    }
+    void limpa()
+    {
+        ArestasNaFaixa.clear();
+    }
+};
+
+class ConjuntoDeFaixas{
+    vector<Faixa> TodasAsFaixas;
+    float YMin, YMax, AlturaDaFaixa;
+
+    // Faixas que cobrem [y1, y2]; false se nenhuma cobre
+    bool IntervaloDeFaixas(float y1, float y2, int &f1, int &f2) const;
+public:
+    ConjuntoDeFaixas();
+    void CriaFaixas(int qtdDeFaixas);
+    void CadastraArestaNaFaixa(int f, int a, Ponto P1, Ponto P2);
+    Faixa &getFaixa(int f)
+    {
+        return TodasAsFaixas[f];
+    }
+    const Faixa &getFaixa(int f) const
+    {
+        return TodasAsFaixas[f];
+    }
+    int getNroDeFaixas() const
+    {
+        return (int)TodasAsFaixas.size();
+    }
+
+    // Cria as faixas sobre o intervalo Y do poligono e cadastra cada
+    // aresta nas faixas que ela atravessa. Com qtdDeFaixas <= 0 usa
+    // uma quantidade proporcional ao numero de arestas.
+    void Constroi(Poligono &P, int qtdDeFaixas);
+
+    // Faixa que contem y, ou -1 se y esta fora do poligono
+    int CalculaFaixa(float y) const;
+
+    // Quantas arestas o raio que sai de P para a esquerda cruza
+    int ContaCruzamentos(Ponto P) const;
+    bool PontoDentro(Ponto P) const
+    {
+        return ContaCruzamentos(P) & 1;
+    }
+    // Indices das arestas cruzadas pelo raio que sai de P para a esquerda
+    int ArestasCruzadas(Ponto P, vector<int> &arestas) const;
+
+    // Dentro, fora ou na borda (a menos de "tolerancia" de uma aresta)
+    PosicaoDoPonto ClassificaPonto(Ponto P, float tolerancia) const;
+
+    // Total de arestas cadastradas (uma aresta conta uma vez por faixa)
+    long getNroDeCadastros() const;
+};
+
+// Mesmo teste, sem indice, percorrendo todas as arestas (referencia)
+int ContaCruzamentosForcaBruta(Poligono &P, Ponto Q);
+PosicaoDoPonto ClassificaPontoForcaBruta(Poligono &P, Ponto Q, float tolerancia);
+
+#endif /* ConjuntoDeFaixas_hpp */
@@ -0,0 +1,53 @@
+//
+//  DivisaoEmBlocos.h
+//  OpenGLTest
+//
+//  Divisao de um vetor de n itens em blocos contiguos, um por thread,
+//  usada pelas rotinas que processam pontos em paralelo
+//  (ClassificadorDePontos, GeradorDePontos, FechoConvexo).
+//
+//      int nBlocos = NroDeBlocos(n, ThreadsDisponiveis(0), 65536);
+//      ExecutaEmBlocos(n, nBlocos, [&](int b, long inicio, long fim) { ... });
+//
+
+#ifndef DivisaoEmBlocos_hpp
+#define DivisaoEmBlocos_hpp
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+// nThreads, se > 0; senao uma por nucleo
+inline int ThreadsDisponiveis(int nThreads)
+{
+    if (nThreads > 0)
+        return nThreads;
+    unsigned nucleos = thread::hardware_concurrency();
+    return nucleos > 0 ? (int)nucleos : 1;
+}
+
+// Quantos blocos usar: no maximo um por thread, e nenhum com menos de
+// itensPorBlocoMin itens (abaixo disso, criar a thread custa mais do
+// que o trabalho). Pelo menos 1.
+inline int NroDeBlocos(long n, int nThreads, long itensPorBlocoMin)
+{
+    return (int)max(1L, min((long)nThreads, n / max(1L, itensPorBlocoMin)));
+}
+
+// Chama Faz(b, inicio, fim) para os nBlocos blocos contiguos de [0, n),
+// cada um na sua thread; a thread atual fica com o ultimo. Retorna
+// depois que todos terminam.
+template <class Funcao>
+void ExecutaEmBlocos(long n, int nBlocos, Funcao Faz)
+{
+    long tamBloco = (n + nBlocos - 1) / max(1, nBlocos);
+    vector<thread> Threads;
+    for (int b = 0; b < nBlocos - 1; b++)
+        Threads.push_back(thread(Faz, b, min(n, b * tamBloco), min(n, (b + 1) * tamBloco)));
+    Faz(nBlocos - 1, min(n, (nBlocos - 1) * tamBloco), n);
+    for (size_t t = 0; t < Threads.size(); t++)
+        Threads[t].join();
+}
+
+#endif /* DivisaoEmBlocos_hpp */
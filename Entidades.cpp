@@ -0,0 +1,125 @@
+//
+//  Entidades.cpp
+//  OpenGLTest
+//
+
+#include "Entidades.h"
+
+ConjuntoDeEntidades::ConjuntoDeEntidades()
+{
+    nEntidades = 0;
+    for (int c = 0; c < N_CATEGORIAS; c++)
+        nPorCategoria[c] = 0;
+}
+
+void ConjuntoDeEntidades::reserva(int capacidade)
+{
+    Transf.reserve(capacidade);
+    TransfAnterior.reserve(capacidade);
+    Vel.reserve(capacidade);
+    Tipo.reserve(capacidade);
+    Forma.reserve(capacidade);
+    Env.reserve(capacidade);
+}
+
+void ConjuntoDeEntidades::limpa()
+{
+    Transf.clear();
+    TransfAnterior.clear();
+    Vel.clear();
+    Tipo.clear();
+    Forma.clear();
+    Env.clear();
+    nEntidades = 0;
+    for (int c = 0; c < N_CATEGORIAS; c++)
+        nPorCategoria[c] = 0;
+}
+
+int ConjuntoDeEntidades::cria(const Entidade &E)
+{
+    Transf.push_back(E.Transf);
+    TransfAnterior.push_back(E.Transf);
+    Vel.push_back(E.Vel);
+    Tipo.push_back(E.Tipo);
+    Forma.push_back(E.Forma);
+    Env.push_back(E.Env);
+    nPorCategoria[E.Tipo.Categoria]++;
+    return nEntidades++;
+}
+
+void ConjuntoDeEntidades::remove(int idx)
+{
+    if (idx < 0 || idx >= nEntidades) return;
+    int ultima = nEntidades - 1;
+    nPorCategoria[Tipo[idx].Categoria]--;
+    if (idx != ultima)
+    {
+        Transf[idx] = Transf[ultima];
+        TransfAnterior[idx] = TransfAnterior[ultima];
+        Vel[idx] = Vel[ultima];
+        Tipo[idx] = Tipo[ultima];
+        Forma[idx] = Forma[ultima];
+        Env[idx] = Env[ultima];
+    }
+    Transf.pop_back();
+    TransfAnterior.pop_back();
+    Vel.pop_back();
+    Tipo.pop_back();
+    Forma.pop_back();
+    Env.pop_back();
+    nEntidades--;
+}
+
+Entidade ConjuntoDeEntidades::le(int idx) const
+{
+    Entidade E;
+    E.Transf = Transf[idx];
+    E.Vel = Vel[idx];
+    E.Tipo = Tipo[idx];
+    E.Forma = Forma[idx];
+    E.Env = Env[idx];
+    return E;
+}
+
+void ConjuntoDeEntidades::escreve(int idx, const Entidade &E)
+{
+    nPorCategoria[Tipo[idx].Categoria]--;
+    nPorCategoria[E.Tipo.Categoria]++;
+    Transf[idx] = E.Transf;
+    TransfAnterior[idx] = E.Transf; // teletransporte: nao interpola
+    Vel[idx] = E.Vel;
+    Tipo[idx] = E.Tipo;
+    Forma[idx] = E.Forma;
+    Env[idx] = E.Env;
+}
+
+void ConjuntoDeEntidades::guardaTransformacoes()
+{
+    TransfAnterior = Transf;
+}
+
+CompTransformacao ConjuntoDeEntidades::interpola(int idx, float alfa) const
+{
+    const CompTransformacao &A = TransfAnterior[idx];
+    const CompTransformacao &B = Transf[idx];
+    CompTransformacao R;
+    R.Posicao.x = A.Posicao.x + (B.Posicao.x - A.Posicao.x) * alfa;
+    R.Posicao.y = A.Posicao.y + (B.Posicao.y - A.Posicao.y) * alfa;
+    R.Posicao.z = B.Posicao.z;
+    // Giros bruscos (ex.: inimigo rebatendo na borda) nao sao interpolados
+    float dRot = B.Rotacao - A.Rotacao;
+    R.Rotacao = (fabs(dRot) < 90.0f) ? A.Rotacao + dRot * alfa : B.Rotacao;
+    return R;
+}
+
+void ConjuntoDeEntidades::avanca(int inicio, float dt)
+{
+    CompTransformacao *T = Transf.data();
+    const CompVelocidade *V = Vel.data();
+    for (int i = inicio; i < nEntidades; i++)
+    {
+        float d = V[i].Velocidade * dt;
+        T[i].Posicao.x += V[i].Direcao.x * d;
+        T[i].Posicao.y += V[i].Direcao.y * d;
+    }
+}
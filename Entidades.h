@@ -0,0 +1,121 @@
+//
+//  Entidades.h
+//  OpenGLTest
+//
+//  Armazenamento dos personagens do jogo em "estrutura de vetores":
+//  cada componente fica num vetor contiguo proprio, indexado pelo
+//  numero da entidade. Os lacos que so precisam de posicao e
+//  velocidade percorrem apenas esses dois vetores, sem trazer para a
+//  cache o resto dos dados de cada personagem.
+//
+//  A remocao troca a entidade removida pela ultima (O(1)); portanto
+//  os indices NAO sao estaveis entre remocoes.
+//
+
+#ifndef Entidades_hpp
+#define Entidades_hpp
+
+#include <vector>
+using namespace std;
+
+#include "Ponto.h"
+#include "AABB.h"
+
+// Dono de um tiro
+enum DonoDoTiro { OWNER_NINGUEM = 0, OWNER_JOGADOR = 1, OWNER_INIMIGO = 2 };
+
+// Categorias com contagem mantida pelo conjunto (consulta em O(1))
+enum CategoriaDeEntidade
+{
+    CAT_JOGADOR,
+    CAT_INIMIGO,
+    CAT_TIRO_JOGADOR,
+    CAT_TIRO_INIMIGO,
+    N_CATEGORIAS
+};
+
+struct CompTransformacao
+{
+    Ponto Posicao;
+    float Rotacao;  // Angulo de rotacao, em graus
+};
+
+struct CompVelocidade
+{
+    Ponto Direcao;     // Vetor de direcao do movimento - compativel com "Rotacao"
+    float Velocidade;  // Velocidade de deslocamento
+};
+
+struct CompTipo
+{
+    int IdDoModelo;
+    int Dono;       // DonoDoTiro; so faz sentido para projeteis
+    int Categoria;  // CategoriaDeEntidade
+};
+
+struct CompForma
+{
+    Ponto Escala;
+    Ponto Pivot;    // Ponto ao redor do qual a entidade sofre rotacao e escala
+};
+
+struct CompEnvelope
+{
+    Ponto Canto[4]; // Quatro vertices do envelope OOBB
+    AABB Caixa;     // Caixa alinhada aos eixos que contem os quatro cantos
+};
+
+// Copia de todos os componentes de uma entidade
+struct Entidade
+{
+    CompTransformacao Transf;
+    CompVelocidade Vel;
+    CompTipo Tipo;
+    CompForma Forma;
+    CompEnvelope Env;
+};
+
+class ConjuntoDeEntidades
+{
+    int nEntidades;
+    int nPorCategoria[N_CATEGORIAS];
+public:
+    vector<CompTransformacao> Transf;
+    vector<CompTransformacao> TransfAnterior; // no inicio do ultimo passo (interpolacao)
+    vector<CompVelocidade> Vel;
+    vector<CompTipo> Tipo;
+    vector<CompForma> Forma;
+    vector<CompEnvelope> Env;
+
+    ConjuntoDeEntidades();
+
+    // Reserva espaco para "capacidade" entidades em todos os vetores
+    void reserva(int capacidade);
+
+    int tamanho() const { return nEntidades; }
+
+    // Quantas entidades da categoria existem; atualizado em cria,
+    // remove, escreve e limpa
+    int conta(int categoria) const { return nPorCategoria[categoria]; }
+    void limpa();
+
+    // Acrescenta uma entidade no fim e retorna o seu indice
+    int cria(const Entidade &E);
+
+    // Remove a entidade idx, colocando a ultima no seu lugar
+    void remove(int idx);
+
+    Entidade le(int idx) const;
+    void escreve(int idx, const Entidade &E);
+
+    // Posicao += Direcao * Velocidade * dt, para as entidades [inicio, tamanho)
+    void avanca(int inicio, float dt);
+
+    // Copia Transf para TransfAnterior; chamar no inicio de cada passo
+    void guardaTransformacoes();
+
+    // Transformacao entre a anterior (alfa=0) e a atual (alfa=1)
+    CompTransformacao interpola(int idx, float alfa) const;
+};
+
+#endif /* Entidades_hpp */
@@ -17,6 +17,7 @@
 #include <cmath>
 #include <ctime>
 #include <fstream>
+#include <algorithm>
 
 using namespace std;
 
@@ -37,6 +38,9 @@ using namespace std;
 
 #include "Ponto.h"
 #include "Poligono.h"
+#include "ConjuntoDeFaixas.h"
+#include "FechoConvexo.h"
+#include "SimplificacaoDePoligonos.h"
 
 #include "Temporizador.h"
 Temporizador T;
@@ -51,56 +55,25 @@ Ponto Min, Max, PontoClicado;
 bool desenha = false;
 bool FoiClicado = false;
 
-class Faixa{
-    vector<int> ArestasNaFaixa;
-public:
-    void CadastraAresta(int a)
-    {
-        ArestasNaFaixa.push_back(a);
-    }
-    int getNroDeArestas()
-    {
-        return ArestasNaFaixa.size();
-    }
-    int getAresta(int i)
-    {
-        return ArestasNaFaixa[i];
-    }
-};
-class ConjuntoDeFaixas{
-    vector<Faixa> TodasAsFaixas;
-
-public:
-    ConjuntoDeFaixas()
-    {
-
-    }
-    void CadastraArestaNaFaixa(int f, int a)
-    {
-        TodasAsFaixas[f].CadastraAresta(a);
-    }
-    void CriaFaixas(int qtdDeFaixas) // pode ser substituda por uma construtora
-    {
-        for (int i=0; i<qtdDeFaixas; i++)
-            TodasAsFaixas.push_back(Faixa());
-    }
-    Faixa getFaixa(int f)
-    {
-        return TodasAsFaixas[f];
-    }
-};
-
 ConjuntoDeFaixas EspacoDividido;
+
+// Niveis de detalhe do mapa. ModoLOD: 0 - original, 1 - Douglas-Peucker,
+// 2 - Visvalingam-Whyatt (tecla 'l'). Zoom com '+' e '-'.
+PiramideDePoligonos PiramideDP, PiramideVW;
+int ModoLOD = 1;
+float Zoom = 1;
+int LarguraJanela = 650, AlturaJanela = 500;
+unsigned long VerticesDesenhados = 0;
+vector<int> ArestasNoRaio; // arestas cruzadas pelo raio do ponto clicado
 float angulo=0.0;
 
 
 void ImprimeFaixas()
 {
-    for (int i=0;i<10;i++)
+    for (int i=0;i<EspacoDividido.getNroDeFaixas();i++)
     {
         cout << "Faixa: " << i << ": ";
-        Faixa f;
-        f = EspacoDividido.getFaixa(i);
+        const Faixa &f = EspacoDividido.getFaixa(i);
         for (int a=0; a<f.getNroDeArestas();a++)
         {
             cout << f.getAresta(a) << " ";
@@ -110,6 +83,15 @@ void ImprimeFaixas()
     }
 }
 
+// **********************************************************************
+// Calcula o fecho convexo do mapa (mostrado com a tecla espaco)
+// **********************************************************************
+void GeraConvexHull()
+{
+    GeraFechoConvexo(Mapa, ConvexHull);
+    cout << "Fecho convexo: " << ConvexHull.getNVertices() << " vertices" << endl;
+}
+
 // **********************************************************************
 //
 // **********************************************************************
@@ -118,19 +100,30 @@ void init()
     // Define a cor do fundo da tela (AZUL)
     glClearColor(0.0f, 0.0f, 1.0f, 1.0f);
 
-    Mapa.LePoligono("PoligonoDeTeste.txt");
-    //Mapa.LePoligono("EstadoRS.txt");
+    //Mapa.LePoligono("PoligonoDeTeste.txt");
+    Mapa.LePoligono("EstadoRS.txt");
     Mapa.obtemLimites(Min,Max);
 
     Min.x--;Min.y--;
     Max.x++;Max.y++;
     //cout << "Vertices no Vetor: " << Mapa.getNVertices() << endl;
-    //GeraConvexHull();
-    EspacoDividido.CriaFaixas(10);
-    EspacoDividido.CadastraArestaNaFaixa(0,11);
-    EspacoDividido.CadastraArestaNaFaixa(3,11);
-    ImprimeFaixas();
-    exit(0);
+    GeraConvexHull();
+    Temporizador TempoLOD;
+    PiramideDP.Constroi(Mapa, SIMPLIFICA_DOUGLAS_PEUCKER);
+    PiramideVW.Constroi(Mapa, SIMPLIFICA_VISVALINGAM);
+    cout << "Niveis de detalhe calculados em " << TempoLOD.getDeltaT()*1000 << " ms:" << endl;
+    for (int k=0; k<PiramideDP.getNroDeNiveis() || k<PiramideVW.getNroDeNiveis(); k++)
+    {
+        cout << "  nivel " << k << ": DP ";
+        if (k < PiramideDP.getNroDeNiveis()) cout << PiramideDP.getNivel(k).getNVertices(); else cout << "-";
+        cout << ", VW ";
+        if (k < PiramideVW.getNroDeNiveis()) cout << PiramideVW.getNivel(k).getNVertices(); else cout << "-";
+        cout << endl;
+    }
+
+    EspacoDividido.Constroi(Mapa, 0);
+    cout << "Faixas: " << EspacoDividido.getNroDeFaixas();
+    cout << " - Arestas cadastradas: " << EspacoDividido.getNroDeCadastros() << endl;
 }
 
 double nFrames=0;
@@ -157,6 +150,7 @@ void animate()
         cout << "Tempo Acumulado: "  << TempoTotal << " segundos. " ;
         cout << "Nros de Frames sem desenho: " << nFrames << endl;
         cout << "FPS(sem desenho): " << nFrames/TempoTotal << endl;
+        cout << "Vertices do mapa desenhados: " << VerticesDesenhados << " de " << Mapa.getNVertices() << endl;
         TempoTotal = 0;
         nFrames = 0;
     }
@@ -173,9 +167,14 @@ void reshape( int w, int h )
     glLoadIdentity();
     // Define a area a ser ocupada pela area OpenGL dentro da Janela
     glViewport(0, 0, w, h);
+    LarguraJanela = w;
+    AlturaJanela = h;
     // Define os limites logicos da area OpenGL dentro da Janela
-    glOrtho(Min.x,Max.x,
-            Min.y,Max.y,
+    // (reduzidos pelo Zoom, em torno do centro)
+    Ponto Meio = (Min + Max) * 0.5;
+    Ponto Metade = (Max - Min) * (0.5 / Zoom);
+    glOrtho(Meio.x - Metade.x, Meio.x + Metade.x,
+            Meio.y - Metade.y, Meio.y + Metade.y,
             0,1);
 
     glMatrixMode(GL_MODELVIEW);
@@ -232,26 +231,41 @@ void display( void )
     glRotatef(angulo, 0,0,1);
     glLineWidth(2);
     glColor3f(1,1,0); // R, G, B  [0..1]
-    Mapa.desenhaPoligono();
+    // Tamanho de um pixel no universo: o nivel escolhido nao tem
+    // erro maior do que isso
+    float unidadesPorPixel = max((Max.x - Min.x) / LarguraJanela, (Max.y - Min.y) / AlturaJanela) / Zoom;
+    if (ModoLOD == 1)
+        VerticesDesenhados = PiramideDP.desenhaPoligono(unidadesPorPixel);
+    else if (ModoLOD == 2)
+        VerticesDesenhados = PiramideVW.desenhaPoligono(unidadesPorPixel);
+    else
+    {
+        Mapa.desenhaPoligono();
+        VerticesDesenhados = Mapa.getNVertices();
+    }
 
     if (FoiClicado == true)
     {
         Ponto Esq;
         Ponto Dir (-1,0);
-        Esq = PontoClicado + Dir * 100;
+        Esq = PontoClicado + Dir * (PontoClicado.x - Min.x);
         glColor3f(0,1,0); // R, G, B  [0..1]
         DesenhaLinha(PontoClicado, Esq);
-        //F = CalculaFaixa(PontoClicado);
 
+        // So as arestas da faixa do ponto sao testadas
         glColor3f(1,0,0); // R, G, B  [0..1]
-        Ponto P1, P2;
-        for (int i=0; i < Mapa.getNVertices();i++)
-        {
-            Mapa.getAresta(i, P1, P2);
-            //if(PassaPelaFaixa(i,F))
-            if (HaInterseccao(PontoClicado,Esq, P1, P2))
-                Mapa.desenhaAresta(i);
-        }
+        for (size_t i=0; i < ArestasNoRaio.size();i++)
+            Mapa.desenhaAresta(ArestasNoRaio[i]);
+
+        // Ponto clicado: verde se dentro, vermelho se fora
+        if (ArestasNoRaio.size() % 2 == 1)
+            glColor3f(0,1,0);
+        else
+            glColor3f(1,0,0);
+        glPointSize(7);
+        glBegin(GL_POINTS);
+            glVertex2f(PontoClicado.x, PontoClicado.y);
+        glEnd();
 
     }
 
@@ -309,6 +323,20 @@ void keyboard ( unsigned char key, int x, int y )
         case ' ':
             desenha = !desenha;
         break;
+        case 'f':
+            ImprimeFaixas();
+            break;
+        case 'l':
+            ModoLOD = (ModoLOD + 1) % 3;
+            cout << "LOD: " << (ModoLOD == 0 ? "original" : ModoLOD == 1 ? "Douglas-Peucker" : "Visvalingam-Whyatt") << endl;
+            glutPostRedisplay();
+            break;
+        case '+':
+        case '-':
+            Zoom *= (key == '+') ? 2 : 0.5;
+            reshape(LarguraJanela, AlturaJanela);
+            glutPostRedisplay();
+            break;
 		default:
 			break;
 	}
@@ -361,6 +389,10 @@ void Mouse(int button,int state,int x,int y)
     PontoClicado = Ponto(ox,oy,oz);
     PontoClicado.imprime("- Ponto no universo: ", "\n");
     FoiClicado = true;
+    EspacoDividido.ArestasCruzadas(PontoClicado, ArestasNoRaio);
+    cout << "Faixa " << EspacoDividido.CalculaFaixa(PontoClicado.y) << ": ";
+    cout << ArestasNoRaio.size() << " cruzamentos - ponto ";
+    cout << (ArestasNoRaio.size() % 2 == 1 ? "DENTRO" : "FORA") << " do poligono" << endl;
 }
 
 
@@ -0,0 +1,247 @@
+//
+//  FechoConvexo.cpp
+//  OpenGLTest
+//
+
+#include <algorithm>
+#include <thread>
+using namespace std;
+
+#include "FechoConvexo.h"
+#include "DivisaoEmBlocos.h"
+
+// Abaixo disto nao vale a pena abrir uma thread
+static const size_t PONTOS_POR_THREAD_MIN = 65536;
+
+// > 0 se C esta a esquerda de A->B, < 0 se a direita, 0 se colinear
+static inline double Orientacao(const Ponto &A, const Ponto &B, const Ponto &C)
+{
+    return ((double)B.x - A.x) * ((double)C.y - A.y) - ((double)B.y - A.y) * ((double)C.x - A.x);
+}
+
+static inline bool MenorXY(const Ponto &A, const Ponto &B)
+{
+    return A.x < B.x || (A.x == B.x && A.y < B.y);
+}
+
+// **********************************************************************
+//  Cadeia monotona de Andrew
+// **********************************************************************
+static void FechoMonotono(vector<Ponto> P, vector<Ponto> &Fecho)
+{
+    Fecho.clear();
+    // Sem repetidos: tres ou mais pontos iguais deixariam [P, P]
+    sort(P.begin(), P.end(), MenorXY);
+    P.erase(unique(P.begin(), P.end(), [](const Ponto &A, const Ponto &B) { return A.x == B.x && A.y == B.y; }),
+            P.end());
+    size_t n = P.size();
+    if (n < 3)
+    {
+        Fecho.swap(P);
+        return;
+    }
+
+    vector<Ponto> H(2 * n);
+    size_t k = 0;
+    for (size_t i = 0; i < n; i++) // cadeia de baixo
+    {
+        while (k >= 2 && Orientacao(H[k - 2], H[k - 1], P[i]) <= 0)
+            k--;
+        H[k++] = P[i];
+    }
+    for (size_t i = n - 1, t = k + 1; i > 0; i--) // cadeia de cima
+    {
+        while (k >= t && Orientacao(H[k - 2], H[k - 1], P[i - 1]) <= 0)
+            k--;
+        H[k++] = P[i - 1];
+    }
+    H.resize(k - 1); // o ultimo repete o primeiro
+    Fecho.swap(H);
+}
+
+// **********************************************************************
+//  Quickhull
+// **********************************************************************
+
+// S tem os pontos estritamente a direita de A->B. Acrescenta em "saida"
+// os vertices do fecho entre A e B (exclusive), na ordem de A para B.
+// S eh consumido.
+static void CadeiaQuickhull(const Ponto &A, const Ponto &B, vector<Ponto> &S,
+                            vector<Ponto> &saida, int threads)
+{
+    if (S.empty())
+        return;
+
+    // Ponto mais distante da reta A-B. Num empate (aresta do fecho
+    // paralela a A-B) fica o mais avancado na direcao A->B, que eh uma
+    // ponta da aresta; um ponto do meio dela sairia como vertice colinear.
+    size_t iMax = 0;
+    double dMax = 0, projMax = 0;
+    double dx = (double)B.x - A.x, dy = (double)B.y - A.y;
+    for (size_t i = 0; i < S.size(); i++)
+    {
+        double d = -Orientacao(A, B, S[i]);
+        double proj = ((double)S[i].x - A.x) * dx + ((double)S[i].y - A.y) * dy;
+        if (d > dMax || (d == dMax && proj > projMax))
+        {
+            dMax = d;
+            projMax = proj;
+            iMax = i;
+        }
+    }
+    Ponto C = S[iMax];
+
+    vector<Ponto> S1, S2;
+    for (size_t i = 0; i < S.size(); i++)
+    {
+        if (Orientacao(A, C, S[i]) < 0)
+            S1.push_back(S[i]);
+        else if (Orientacao(C, B, S[i]) < 0)
+            S2.push_back(S[i]);
+    }
+    vector<Ponto>().swap(S); // libera a memoria antes de descer
+
+    if (threads > 1 && min(S1.size(), S2.size()) >= PONTOS_POR_THREAD_MIN)
+    {
+        vector<Ponto> saida1;
+        int t1 = threads / 2;
+        thread T(CadeiaQuickhull, cref(A), cref(C), ref(S1), ref(saida1), t1);
+        vector<Ponto> saida2;
+        CadeiaQuickhull(C, B, S2, saida2, threads - t1);
+        T.join();
+        saida.insert(saida.end(), saida1.begin(), saida1.end());
+        saida.push_back(C);
+        saida.insert(saida.end(), saida2.begin(), saida2.end());
+    }
+    else
+    {
+        CadeiaQuickhull(A, C, S1, saida, 1);
+        saida.push_back(C);
+        CadeiaQuickhull(C, B, S2, saida, 1);
+    }
+}
+
+// Separa o bloco [inicio, fim) em pontos abaixo e acima de L->R
+static void SeparaBloco(const vector<Ponto> *P, size_t inicio, size_t fim, Ponto L, Ponto R,
+                        vector<Ponto> *Abaixo, vector<Ponto> *Acima)
+{
+    for (size_t i = inicio; i < fim; i++)
+    {
+        double o = Orientacao(L, R, (*P)[i]);
+        if (o < 0)
+            Abaixo->push_back((*P)[i]);
+        else if (o > 0)
+            Acima->push_back((*P)[i]);
+    }
+}
+
+static void FechoQuickhull(const vector<Ponto> &P, vector<Ponto> &Fecho, int nThreads)
+{
+    Fecho.clear();
+    if (P.empty())
+        return;
+    size_t n = P.size();
+
+    Ponto L = P[0], R = P[0];
+    for (size_t i = 1; i < n; i++)
+    {
+        if (MenorXY(P[i], L)) L = P[i];
+        if (MenorXY(R, P[i])) R = P[i];
+    }
+    Fecho.push_back(L);
+    if (L.x == R.x && L.y == R.y)
+        return;
+
+    // Separacao inicial em blocos, um por thread
+    int threads = ThreadsDisponiveis(nThreads);
+    int nBlocos = NroDeBlocos((long)n, threads, (long)PONTOS_POR_THREAD_MIN);
+    vector<vector<Ponto> > Abaixo(nBlocos), Acima(nBlocos);
+    ExecutaEmBlocos((long)n, nBlocos, [&](int b, long inicio, long fim) {
+        SeparaBloco(&P, inicio, fim, L, R, &Abaixo[b], &Acima[b]);
+    });
+    for (int b = 1; b < nBlocos; b++)
+    {
+        Abaixo[0].insert(Abaixo[0].end(), Abaixo[b].begin(), Abaixo[b].end());
+        Acima[0].insert(Acima[0].end(), Acima[b].begin(), Acima[b].end());
+        vector<Ponto>().swap(Abaixo[b]);
+        vector<Ponto>().swap(Acima[b]);
+    }
+
+    // Cadeia de baixo (L->R) e de cima (R->L) em paralelo
+    vector<Ponto> CadeiaDeCima;
+    int tCima = threads / 2;
+    if (tCima >= 1 && Acima[0].size() >= PONTOS_POR_THREAD_MIN && Abaixo[0].size() >= PONTOS_POR_THREAD_MIN)
+    {
+        thread T(CadeiaQuickhull, cref(R), cref(L), ref(Acima[0]), ref(CadeiaDeCima), tCima);
+        CadeiaQuickhull(L, R, Abaixo[0], Fecho, threads - tCima);
+        T.join();
+    }
+    else
+    {
+        CadeiaQuickhull(L, R, Abaixo[0], Fecho, threads);
+        CadeiaQuickhull(R, L, Acima[0], CadeiaDeCima, threads);
+    }
+    Fecho.push_back(R);
+    Fecho.insert(Fecho.end(), CadeiaDeCima.begin(), CadeiaDeCima.end());
+}
+
+// **********************************************************************
+//  Filtro de Akl-Toussaint
+// **********************************************************************
+void FiltraAklToussaint(const vector<Ponto> &Pontos, vector<Ponto> &Restantes)
+{
+    Restantes.clear();
+    if (Pontos.size() < 4)
+    {
+        Restantes = Pontos;
+        return;
+    }
+    Ponto Esq = Pontos[0], Dir = Pontos[0], Baixo = Pontos[0], Cima = Pontos[0];
+    for (size_t i = 1; i < Pontos.size(); i++)
+    {
+        const Ponto &P = Pontos[i];
+        if (P.x < Esq.x) Esq = P;
+        if (P.x > Dir.x) Dir = P;
+        if (P.y < Baixo.y) Baixo = P;
+        if (P.y > Cima.y) Cima = P;
+    }
+    // Quadrilatero anti-horario: baixo, direita, cima, esquerda.
+    // Um ponto so eh descartado se estiver estritamente dentro; com
+    // extremos repetidos alguma aresta degenera e nada eh descartado.
+    for (size_t i = 0; i < Pontos.size(); i++)
+    {
+        const Ponto &P = Pontos[i];
+        if (Orientacao(Baixo, Dir, P) > 0 && Orientacao(Dir, Cima, P) > 0 &&
+            Orientacao(Cima, Esq, P) > 0 && Orientacao(Esq, Baixo, P) > 0)
+            continue;
+        Restantes.push_back(P);
+    }
+}
+
+// **********************************************************************
+void CalculaFechoConvexo(const vector<Ponto> &Pontos, vector<Ponto> &Fecho,
+                         MetodoDoFecho metodo, bool preFiltro, int nThreads)
+{
+    vector<Ponto> Filtrados;
+    const vector<Ponto> *Entrada = &Pontos;
+    if (preFiltro)
+    {
+        FiltraAklToussaint(Pontos, Filtrados);
+        Entrada = &Filtrados;
+    }
+    if (metodo == FECHO_QUICKHULL)
+        FechoQuickhull(*Entrada, Fecho, nThreads);
+    else
+        FechoMonotono(*Entrada, Fecho);
+}
+
+void GeraFechoConvexo(Poligono &Entrada, Poligono &Fecho,
+                      MetodoDoFecho metodo, bool preFiltro, int nThreads)
+{
+    vector<Ponto> H;
+    CalculaFechoConvexo(Entrada.getVertices(), H, metodo, preFiltro, nThreads);
+    Fecho.limpa();
+    Fecho.reservaVertices(H.size());
+    for (size_t i = 0; i < H.size(); i++)
+        Fecho.insereVertice(H[i]);
+}
@@ -0,0 +1,49 @@
+//
+//  FechoConvexo.h
+//  OpenGLTest
+//
+//  Calculo do fecho convexo (convex hull) de um conjunto de pontos.
+//
+//  Metodos:
+//   - FECHO_MONOTONO: cadeia monotona de Andrew, O(n log n). Eh o padrao.
+//   - FECHO_QUICKHULL: quickhull, O(n log n) em media. As duas metades
+//     do fecho (e as sub-cadeias mais pesadas) sao calculadas em
+//     threads separadas; compensa para entradas muito grandes.
+//
+//  Opcionalmente, antes do calculo, o filtro de Akl-Toussaint descarta
+//  os pontos que estao dentro do quadrilatero formado pelos pontos
+//  extremos (menor e maior x, menor e maior y). Em nuvens uniformes ele
+//  elimina a maior parte dos pontos em O(n).
+//
+//  O fecho sai em sentido anti-horario, comecando pelo ponto de menor x
+//  (e menor y, em caso de empate), sem pontos colineares.
+//
+
+#ifndef FechoConvexo_hpp
+#define FechoConvexo_hpp
+
+#include <vector>
+using namespace std;
+
+#include "Ponto.h"
+#include "Poligono.h"
+
+enum MetodoDoFecho
+{
+    FECHO_MONOTONO,
+    FECHO_QUICKHULL
+};
+
+// nThreads so eh usado pelo quickhull (0: uma por nucleo)
+void CalculaFechoConvexo(const vector<Ponto> &Pontos, vector<Ponto> &Fecho,
+                         MetodoDoFecho metodo = FECHO_MONOTONO, bool preFiltro = false, int nThreads = 0);
+
+// Copia para "Restantes" os pontos que nao estao estritamente dentro
+// do quadrilatero dos pontos extremos
+void FiltraAklToussaint(const vector<Ponto> &Pontos, vector<Ponto> &Restantes);
+
+// Fecho dos vertices de "Entrada", guardado em "Fecho"
+void GeraFechoConvexo(Poligono &Entrada, Poligono &Fecho,
+                      MetodoDoFecho metodo = FECHO_MONOTONO, bool preFiltro = false, int nThreads = 0);
+
+#endif /* FechoConvexo_hpp */
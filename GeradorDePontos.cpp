@@ -0,0 +1,182 @@
+//
+//  GeradorDePontos.cpp
+//  OpenGLTest
+//
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+using namespace std;
+
+#include "GeradorDePontos.h"
+#include "DivisaoEmBlocos.h"
+
+// Minimo de pontos por bloco em NroDeBlocos
+static const long PONTOS_POR_THREAD_MIN = 65536;
+
+// Sorteios por ponto: o k de (semente, i, k)
+static const uint64_t SORTEIOS_POR_PONTO = 32;
+
+// Tentativas de cair dentro da caixa antes de prender na borda
+static const int TENTATIVAS_NO_GRUPO = 8;
+
+const char *NomeDaDistribuicao(DistribuicaoDosPontos d)
+{
+    const char *Nomes[] = {"uniforme", "agrupada", "grade"};
+    return Nomes[d];
+}
+
+bool DistribuicaoPeloNome(const char *nome, DistribuicaoDosPontos &d)
+{
+    for (int k = PONTOS_UNIFORMES; k <= PONTOS_EM_GRADE; k++)
+        if (strcmp(nome, NomeDaDistribuicao((DistribuicaoDosPontos)k)) == 0)
+        {
+            d = (DistribuicaoDosPontos)k;
+            return true;
+        }
+    return false;
+}
+
+// **********************************************************************
+//  Numeros aleatorios por contador
+// **********************************************************************
+// Finalizador do SplitMix64: espalha qualquer mudanca de um bit da
+// entrada por toda a saida
+static inline uint64_t Mistura(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// k-esimo numero do ponto i, em [0, 1) com 24 bits
+static inline float Sorteio(uint64_t semente, uint64_t i, uint64_t k)
+{
+    uint64_t h = Mistura(semente + Mistura(i * SORTEIOS_POR_PONTO + k));
+    return (float)(h >> 40) * (1.0f / 16777216.0f);
+}
+
+// Fluxo separado do dos pontos para os centros dos grupos
+static const uint64_t FLUXO_DOS_GRUPOS = 0x9e3779b97f4a7c15ULL;
+
+// **********************************************************************
+//  Distribuicoes
+// **********************************************************************
+struct ParametrosDaGeracao
+{
+    uint64_t Semente;
+    DistribuicaoDosPontos Distribuicao;
+    Ponto Min, Tamanho;
+    long Colunas, Linhas;             // grade
+    vector<Ponto> Centros;            // grupos
+    float Desvio;                     // grupos, em unidades da caixa
+};
+
+static Ponto PontoUniforme(const ParametrosDaGeracao &G, long i)
+{
+    return Ponto(G.Min.x + Sorteio(G.Semente, i, 0) * G.Tamanho.x,
+                 G.Min.y + Sorteio(G.Semente, i, 1) * G.Tamanho.y);
+}
+
+static Ponto PontoNaGrade(const ParametrosDaGeracao &G, long i)
+{
+    long c = i % G.Colunas, l = i / G.Colunas;
+    return Ponto(G.Min.x + (c + Sorteio(G.Semente, i, 0)) * (G.Tamanho.x / G.Colunas),
+                 G.Min.y + (l + Sorteio(G.Semente, i, 1)) * (G.Tamanho.y / G.Linhas));
+}
+
+// Gaussiana por Box-Muller; sorteia de novo se sair da caixa
+static Ponto PontoAgrupado(const ParametrosDaGeracao &G, long i)
+{
+    const Ponto &C = G.Centros[(long)(Sorteio(G.Semente, i, 0) * G.Centros.size())];
+    float x = C.x, y = C.y;
+    for (int t = 0; t < TENTATIVAS_NO_GRUPO; t++)
+    {
+        float u = 1.0f - Sorteio(G.Semente, i, 1 + 2 * t); // (0, 1]: log(u) finito
+        float v = Sorteio(G.Semente, i, 2 + 2 * t);
+        float r = G.Desvio * sqrt(-2.0f * log(u));
+        x = C.x + r * cos(2 * (float)M_PI * v);
+        y = C.y + r * sin(2 * (float)M_PI * v);
+        if (x >= G.Min.x && x <= G.Min.x + G.Tamanho.x && y >= G.Min.y && y <= G.Min.y + G.Tamanho.y)
+            break;
+    }
+    x = min(max(x, G.Min.x), G.Min.x + G.Tamanho.x);
+    y = min(max(y, G.Min.y), G.Min.y + G.Tamanho.y);
+    return Ponto(x, y);
+}
+
+static void GeraIntervalo(const ParametrosDaGeracao *G, Ponto *Pontos, long inicio, long fim)
+{
+    switch (G->Distribuicao)
+    {
+    case PONTOS_AGRUPADOS:
+        for (long i = inicio; i < fim; i++)
+            Pontos[i] = PontoAgrupado(*G, i);
+        break;
+    case PONTOS_EM_GRADE:
+        for (long i = inicio; i < fim; i++)
+            Pontos[i] = PontoNaGrade(*G, i);
+        break;
+    default:
+        for (long i = inicio; i < fim; i++)
+            Pontos[i] = PontoUniforme(*G, i);
+        break;
+    }
+}
+
+// **********************************************************************
+//  GeradorDePontos
+// **********************************************************************
+GeradorDePontos::GeradorDePontos(uint64_t semente, DistribuicaoDosPontos d)
+{
+    Semente = semente;
+    Distribuicao = d;
+    NroDeGrupos = 16;
+    DispersaoDosGrupos = 0.03f;
+    NroDeThreads = 0;
+}
+
+void GeradorDePontos::setGrupos(int nroDeGrupos, float dispersao)
+{
+    NroDeGrupos = max(1, nroDeGrupos);
+    DispersaoDosGrupos = max(0.0f, dispersao);
+}
+
+void GeradorDePontos::setNroDeThreads(int n)
+{
+    NroDeThreads = max(0, n);
+}
+
+int GeradorDePontos::getNroDeThreads() const
+{
+    return ThreadsDisponiveis(NroDeThreads);
+}
+
+void GeradorDePontos::Gera(Ponto *Pontos, long n, Ponto Min, Ponto Max) const
+{
+    ParametrosDaGeracao G;
+    G.Semente = Semente;
+    G.Distribuicao = Distribuicao;
+    G.Min = Min;
+    G.Tamanho = Max - Min;
+
+    // Grade com celulas quase quadradas: colunas/linhas ~ largura/altura
+    double proporcao = (G.Tamanho.y > 0) ? G.Tamanho.x / G.Tamanho.y : 1;
+    G.Colunas = max(1L, (long)ceil(sqrt(n * proporcao)));
+    G.Linhas = max(1L, (n + G.Colunas - 1) / G.Colunas);
+
+    G.Desvio = DispersaoDosGrupos * max(G.Tamanho.x, G.Tamanho.y);
+    if (Distribuicao == PONTOS_AGRUPADOS)
+        for (int g = 0; g < NroDeGrupos; g++)
+            G.Centros.push_back(Ponto(Min.x + Sorteio(Semente ^ FLUXO_DOS_GRUPOS, g, 0) * G.Tamanho.x,
+                                      Min.y + Sorteio(Semente ^ FLUXO_DOS_GRUPOS, g, 1) * G.Tamanho.y));
+
+    ExecutaEmBlocos(n, NroDeBlocos(n, getNroDeThreads(), PONTOS_POR_THREAD_MIN),
+                    [&](int, long inicio, long fim) { GeraIntervalo(&G, Pontos, inicio, fim); });
+}
+
+void GeradorDePontos::Gera(vector<Ponto> &Pontos, long n, Ponto Min, Ponto Max) const
+{
+    Pontos.resize(n);
+    Gera(Pontos.data(), n, Min, Max);
+}
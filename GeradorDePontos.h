@@ -0,0 +1,74 @@
+//
+//  GeradorDePontos.h
+//  OpenGLTest
+//
+//  Nuvens de pontos aleatorios reproduziveis e geradas em paralelo.
+//  O ponto i eh funcao so da semente e de i (gerador baseado em
+//  contador: cada numero aleatorio eh um hash de (semente, i, k)), entao
+//  o vetor pode ser dividido entre threads em qualquer quantidade e o
+//  resultado eh sempre o mesmo. O vetor eh alocado uma vez e cada
+//  thread preenche um bloco contiguo.
+//
+//  Distribuicoes, sempre dentro de [Min, Max]:
+//   - uniforme: coordenadas continuas (24 bits), sem a repeticao de
+//     posicoes de rand() % 1000;
+//   - agrupada: NroDeGrupos nuvens gaussianas com centros aleatorios e
+//     desvio padrao de DispersaoDosGrupos * largura;
+//   - em grade: uma celula por ponto numa grade com o formato da
+//     caixa, com o ponto sorteado dentro da celula.
+//
+//      GeradorDePontos G(42, PONTOS_AGRUPADOS);
+//      G.Gera(Pontos, 10000000, Ponto(0, 0), Ponto(500, 500));
+//
+
+#ifndef GeradorDePontos_hpp
+#define GeradorDePontos_hpp
+
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+#include "Ponto.h"
+
+enum DistribuicaoDosPontos
+{
+    PONTOS_UNIFORMES,
+    PONTOS_AGRUPADOS,
+    PONTOS_EM_GRADE
+};
+
+const char *NomeDaDistribuicao(DistribuicaoDosPontos d);
+
+// Pelo nome ("uniforme", "agrupada" ou "grade"); false se nao conhece
+bool DistribuicaoPeloNome(const char *nome, DistribuicaoDosPontos &d);
+
+class GeradorDePontos
+{
+    uint64_t Semente;
+    DistribuicaoDosPontos Distribuicao;
+    int NroDeGrupos;
+    float DispersaoDosGrupos;
+    int NroDeThreads;
+public:
+    GeradorDePontos(uint64_t semente = 1, DistribuicaoDosPontos d = PONTOS_UNIFORMES);
+
+    void setSemente(uint64_t s) { Semente = s; }
+    uint64_t getSemente() const { return Semente; }
+    void setDistribuicao(DistribuicaoDosPontos d) { Distribuicao = d; }
+    DistribuicaoDosPontos getDistribuicao() const { return Distribuicao; }
+
+    // So para PONTOS_AGRUPADOS (padrao: 16 grupos, 0.03 da largura)
+    void setGrupos(int nroDeGrupos, float dispersao);
+
+    // 0: uma thread por nucleo
+    void setNroDeThreads(int n);
+    int getNroDeThreads() const;
+
+    // Escreve n pontos em Pontos[0..n-1]
+    void Gera(Ponto *Pontos, long n, Ponto Min, Ponto Max) const;
+
+    // Redimensiona o vetor para n pontos e preenche
+    void Gera(vector<Ponto> &Pontos, long n, Ponto Min, Ponto Max) const;
+};
+
+#endif /* GeradorDePontos_hpp */
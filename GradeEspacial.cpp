@@ -0,0 +1,116 @@
+//
+//  GradeEspacial.cpp
+//  OpenGLTest
+//
+
+#include <cmath>
+#include "GradeEspacial.h"
+
+GradeEspacial::GradeEspacial(float tamanhoCelula)
+{
+    TamanhoCelula = tamanhoCelula;
+    MarcaAtual = 0;
+    MascaraTabela = 0;
+}
+
+void GradeEspacial::setTamanhoCelula(float t)
+{
+    if (t >= 0.5f) // celulas menores multiplicam as entradas de cada objeto
+        TamanhoCelula = t;
+}
+
+float GradeEspacial::getTamanhoCelula() const
+{
+    return TamanhoCelula;
+}
+
+void GradeEspacial::celula(float x, float y, int &cx, int &cy) const
+{
+    cx = (int)floor(x / TamanhoCelula);
+    cy = (int)floor(y / TamanhoCelula);
+}
+
+unsigned GradeEspacial::balde(int cx, int cy) const
+{
+    return ((unsigned)cx * 73856093u ^ (unsigned)cy * 19349663u) & MascaraTabela;
+}
+
+void GradeEspacial::limpa()
+{
+    CelX.clear();
+    CelY.clear();
+    IdDaEntrada.clear();
+}
+
+void GradeEspacial::insere(int id, const AABB &caixa)
+{
+    int x0, y0, x1, y1;
+    celula(caixa.minX, caixa.minY, x0, y0);
+    celula(caixa.maxX, caixa.maxY, x1, y1);
+    for (int cy = y0; cy <= y1; cy++)
+        for (int cx = x0; cx <= x1; cx++)
+        {
+            CelX.push_back(cx);
+            CelY.push_back(cy);
+            IdDaEntrada.push_back(id);
+        }
+}
+
+// Ordenacao por contagem das entradas nos baldes: O(entradas)
+void GradeEspacial::fecha()
+{
+    int nEntradas = (int)IdDaEntrada.size();
+    unsigned tam = 16;
+    while (tam < 2u * (unsigned)nEntradas)
+        tam *= 2;
+    MascaraTabela = tam - 1;
+
+    InicioDoBalde.assign(tam + 1, 0);
+    int maiorId = -1;
+    for (int e = 0; e < nEntradas; e++)
+    {
+        InicioDoBalde[balde(CelX[e], CelY[e]) + 1]++;
+        maiorId = max(maiorId, IdDaEntrada[e]);
+    }
+    for (unsigned b = 0; b < tam; b++)
+        InicioDoBalde[b + 1] += InicioDoBalde[b];
+
+    Objetos.resize(nEntradas);
+    vector<int> proximo(InicioDoBalde.begin(), InicioDoBalde.end() - 1);
+    for (int e = 0; e < nEntradas; e++)
+        Objetos[proximo[balde(CelX[e], CelY[e])]++] = IdDaEntrada[e];
+
+    if ((int)Marca.size() < maiorId + 1)
+        Marca.resize(maiorId + 1, 0);
+}
+
+void GradeEspacial::obtemCandidatos(const AABB &caixa, vector<int> &candidatos)
+{
+    candidatos.clear();
+    if (Objetos.empty())
+        return;
+
+    if (++MarcaAtual == 0) // deu a volta: zera as marcas antigas
+    {
+        fill(Marca.begin(), Marca.end(), 0);
+        MarcaAtual = 1;
+    }
+
+    int x0, y0, x1, y1;
+    celula(caixa.minX, caixa.minY, x0, y0);
+    celula(caixa.maxX, caixa.maxY, x1, y1);
+    for (int cy = y0; cy <= y1; cy++)
+        for (int cx = x0; cx <= x1; cx++)
+        {
+            unsigned b = balde(cx, cy);
+            for (int k = InicioDoBalde[b]; k < InicioDoBalde[b + 1]; k++)
+            {
+                int id = Objetos[k];
+                if (Marca[id] != MarcaAtual)
+                {
+                    Marca[id] = MarcaAtual;
+                    candidatos.push_back(id);
+                }
+            }
+        }
+}
@@ -0,0 +1,53 @@
+//
+//  GradeEspacial.h
+//  OpenGLTest
+//
+//  Grade uniforme com hash espacial para a fase ampla (broadphase)
+//  da deteccao de colisao. A grade eh reconstruida a cada passo:
+//
+//      Grade.limpa();
+//      for (...) Grade.insere(id, caixa);
+//      Grade.fecha();
+//      Grade.obtemCandidatos(caixa, lista);
+//
+//  Cada objeto entra em todas as celulas que a sua caixa toca e uma
+//  consulta devolve (sem repeticao) os objetos das celulas tocadas
+//  pela caixa consultada. Celulas diferentes podem cair no mesmo
+//  balde da tabela; isso so gera candidatos a mais, que o teste
+//  exato descarta.
+//
+
+#ifndef GradeEspacial_hpp
+#define GradeEspacial_hpp
+
+#include <vector>
+using namespace std;
+
+#include "AABB.h"
+
+class GradeEspacial
+{
+    float TamanhoCelula;
+    vector<int> CelX, CelY;       // celula de cada entrada inserida
+    vector<int> IdDaEntrada;      // objeto de cada entrada inserida
+    vector<int> InicioDoBalde;    // entradas do balde b: [InicioDoBalde[b], InicioDoBalde[b+1])
+    vector<int> Objetos;          // ids agrupados por balde
+    vector<unsigned> Marca;       // evita repetir candidatos na mesma consulta
+    unsigned MarcaAtual;
+    unsigned MascaraTabela;
+
+    void celula(float x, float y, int &cx, int &cy) const;
+    unsigned balde(int cx, int cy) const;
+public:
+    GradeEspacial(float tamanhoCelula = 4.0f);
+
+    void setTamanhoCelula(float t);
+    float getTamanhoCelula() const;
+
+    void limpa();
+    void insere(int id, const AABB &caixa);
+    void fecha(); // organiza os baldes; chamar apos as insercoes
+    void obtemCandidatos(const AABB &caixa, vector<int> &candidatos);
+};
+
+#endif /* GradeEspacial_hpp */
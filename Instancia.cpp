@@ -10,31 +10,20 @@
 
 void DesenhaPersonagem();
 void DesenhaRetangulo();
+PilhaDeMatrizes PilhaDeModelagem;
+
 // ***********************************************************
 //  void InstanciaPonto(Ponto3D *p, Ponto3D *out)
 //  Esta funcao calcula as coordenadas de um ponto no
 //  sistema de referencia do universo (SRU), ou seja,
 //  aplica as rotacoes, escalas e translacoes a um
 //  ponto no sistema de referencia do objeto (SRO).
+//  Usa a copia da matriz na CPU (PilhaDeModelagem); nao
+//  consulta o OpenGL.
 // ***********************************************************
 void InstanciaPonto(Ponto &p, Ponto &out)
 {
-    GLfloat ponto_novo[4];
-    GLfloat matriz_gl[4][4];
-    int  i;
-    
-    glGetFloatv(GL_MODELVIEW_MATRIX,&matriz_gl[0][0]);
-    
-    for(i=0;i<4;i++)
-    {
-        ponto_novo[i]= matriz_gl[0][i] * p.x+
-        matriz_gl[1][i] * p.y+
-        matriz_gl[2][i] * p.z+
-        matriz_gl[3][i];
-    }
-    out.x=ponto_novo[0];
-    out.y=ponto_novo[1];
-    out.z=ponto_novo[2];
+    out = PilhaDeModelagem.topo().aplica(p);
 }
 
 Ponto InstanciaPonto(Ponto P)
@@ -52,15 +41,22 @@ Instancia::Instancia()
     Pivot = Ponto(0,0,0);
 }
 
+Matriz2D Instancia::matriz() const
+{
+    return MatrizDeInstanciamento(Posicao, Pivot, Rotacao, Escala);
+}
+
 void Instancia::desenha()
 {
-    // Aplica as transformacoes geometricas no modelo
+    // Aplica as transformacoes geometricas no modelo, na CPU e no OpenGL
+    Matriz2D M = matriz();
+    GLfloat matriz_gl[16];
+    M.paraOpenGL(matriz_gl);
+
+    PilhaDeModelagem.empilha();
+    PilhaDeModelagem.multiplica(M);
     glPushMatrix();
-        glTranslatef(Posicao.x, Posicao.y, 0);
-        glTranslatef(Pivot.x, Pivot.y, Pivot.z);
-        glRotatef(Rotacao, 0,0,1);
-        glScalef(Escala.x, Escala.y, Escala.z);
-        glTranslatef(-Pivot.x, -Pivot.y, -Pivot.z);
+        glMultMatrixf(matriz_gl);
 
         // Obtem a posicao do ponto 0,0,0 no SRU
         // Nao eh usado aqui, mas eh util para detectar colisoes
@@ -69,6 +65,7 @@ void Instancia::desenha()
         (*modelo)(); // desenha a instancia
         
     glPopMatrix();
+    PilhaDeModelagem.desempilha();
 }
 
 void Instancia::AtualizaPosicao(double tempoDecorrido)
@@ -13,8 +13,14 @@
 using namespace std;
 
 #include "Poligono.h"
+#include "Matriz2D.h"
 typedef void TipoFuncao();
 
+// Copia na CPU da matriz MODELVIEW usada ao desenhar as instancias.
+// Quem aplica transformacoes antes de Instancia::desenha() deve
+// aplica-las tambem aqui, para que PosicaoDoPersonagem saia no SRU.
+extern PilhaDeMatrizes PilhaDeModelagem;
+
 class Instancia{
 public:
     //Poligono *modelo;
@@ -42,6 +48,9 @@ public:
 
     double r,g,b;
     
+    // Matriz que leva do sistema do objeto (SRO) para o do pai
+    Matriz2D matriz() const;
+
     // Método que desenha a instancia
     void desenha();
     
@@ -11,6 +11,8 @@
 #include <iomanip>
 #include <cmath>
 #include <ctime>
+#include <cstdlib>
+#include <vector>
    
    
 using namespace std;
@@ -32,6 +34,7 @@ using namespace std;
  
 #include "Ponto.h"
 #include "Linha.h"
+#include "VarreduraDeLinhas.h"
 
 #include "Temporizador.h"
 
@@ -41,7 +44,12 @@ const int MAX_X = 100;  // Coordenada X maxima da janela
 
 int ContChamadas;
 
-Linha Linhas[N_LINHAS];
+int nLinhas = N_LINHAS; // pode ser alterado pela linha de comando
+vector<Linha> Linhas;
+
+// true: varredura (Bentley-Ottmann); false: forca bruta (referencia)
+bool UsaVarredura = true;
+vector<ParDeInterseccao> Pares;
 
 // **********************************************************************
 //  void init(void)
@@ -54,7 +62,8 @@ void init(void)
     
     srand(unsigned(time(NULL)));
     
-    for(int i=0; i< N_LINHAS; i++)
+    Linhas.resize(nLinhas);
+    for(int i=0; i< nLinhas; i++)
         Linhas[i].geraLinha(MAX_X, 10);
 }
 
@@ -86,38 +95,88 @@ void reshape( int w, int h )
 void DesenhaLinhas()
 {
     glColor3f(0,1,0);
-    for(int i=0; i< N_LINHAS; i++)
+    for(int i=0; i< nLinhas; i++)
         Linhas[i].desenhaLinha();
 }
 
+// **********************************************************************
+// void CalculaInterseccoes()
+//  Preenche "Pares" usando o metodo selecionado
+// **********************************************************************
+void CalculaInterseccoes()
+{
+    if (UsaVarredura)
+        CalculaInterseccoesVarredura(&Linhas[0], nLinhas, Pares);
+    else
+        CalculaInterseccoesForcaBruta(&Linhas[0], nLinhas, Pares);
+}
+
 // **********************************************************************
 // void DesenhaCenario()
 // **********************************************************************
 void DesenhaCenario()
 {
-    Ponto PA, PB, PC, PD;
-    ContChamadas = 0;
     resetContadorInt();
+    CalculaInterseccoes();
+    ContChamadas = getContadorInt();
     
     // Desenha as linhas do cenário
     glLineWidth(1);
     glColor3f(1,0,0);
     
-    for(int i=0; i< N_LINHAS; i++)
+    for(size_t k=0; k< Pares.size(); k++)
+    {
+        Linhas[Pares[k].i].desenhaLinha();
+        Linhas[Pares[k].j].desenhaLinha();
+    }
+}
+// **********************************************************************
+// void ConfereInterseccoes()
+//  Roda os dois metodos sobre as linhas atuais e compara os resultados
+// **********************************************************************
+void ConfereInterseccoes()
+{
+    vector<ParDeInterseccao> Bruta, Varredura;
+    CalculaInterseccoesForcaBruta(&Linhas[0], nLinhas, Bruta);
+    CalculaInterseccoesVarredura(&Linhas[0], nLinhas, Varredura);
+    cout << "Forca bruta: " << Bruta.size() << " pares. ";
+    cout << "Varredura: " << Varredura.size() << " pares. ";
+    cout << "Divergencias: " << ComparaInterseccoes(Bruta, Varredura) << endl;
+}
+// **********************************************************************
+// void ComparaTempos()
+//  Mede os dois metodos para quantidades crescentes de linhas
+// **********************************************************************
+void ComparaTempos()
+{
+    int Quantidades[] = {1000, 2000, 5000, 10000, 20000, 50000, 100000};
+    vector<Linha> L;
+    vector<ParDeInterseccao> Bruta, Varredura;
+    Temporizador Tempo;
+
+    cout << setw(8) << "linhas" << setw(10) << "pares"
+         << setw(14) << "bruta(s)" << setw(14) << "varredura(s)" << setw(8) << "difs" << endl;
+    for (int q = 0; q < 7; q++)
     {
-        PA.set(Linhas[i].x1, Linhas[i].y1);
-        PB.set(Linhas[i].x2, Linhas[i].y2);
-        for(int j=0; j< N_LINHAS; j++)
+        int n = Quantidades[q];
+        L.resize(n);
+        for (int i = 0; i < n; i++)
+            L[i].geraLinha(MAX_X, 10);
+
+        Tempo.getDeltaT();
+        CalculaInterseccoesVarredura(&L[0], n, Varredura);
+        double tVarredura = Tempo.getDeltaT();
+
+        cout << setw(8) << n << setw(10) << Varredura.size();
+        if (n <= 20000) // acima disso a forca bruta demora demais
         {
-            PC.set(Linhas[j].x1, Linhas[j].y1);
-            PD.set(Linhas[j].x2, Linhas[j].y2);
-            ContChamadas++;
-            if (HaInterseccao(PA, PB, PC, PD))
-            {
-                Linhas[i].desenhaLinha();
-                Linhas[j].desenhaLinha();
-            }
+            CalculaInterseccoesForcaBruta(&L[0], n, Bruta);
+            double tBruta = Tempo.getDeltaT();
+            cout << setw(14) << tBruta << setw(14) << tVarredura
+                 << setw(8) << ComparaInterseccoes(Bruta, Varredura) << endl;
         }
+        else
+            cout << setw(14) << "-" << setw(14) << tVarredura << setw(8) << "-" << endl;
     }
 }
 // **********************************************************************
@@ -164,7 +223,8 @@ void animate()
         cout << "FPS(sem desenho): " << nFrames/TempoTotal << endl;
         TempoTotal = 0;
         nFrames = 0;
-        cout << "Contador (de Intersecoes Existentes:" << getContadorInt()/2.0 << endl;
+        cout << "Metodo: " << (UsaVarredura ? "varredura" : "forca bruta") << endl;
+        cout << "Pares de linhas que se intersectam: " << Pares.size() << endl;
         cout << "Contador de Chamadas:" << ContChamadas << endl;
     }
 }
@@ -181,6 +241,16 @@ void keyboard ( unsigned char key, int x, int y )
     case' ':
             init();
         break;
+    case 'v':
+            UsaVarredura = !UsaVarredura;
+            cout << "Metodo: " << (UsaVarredura ? "varredura" : "forca bruta") << endl;
+        break;
+    case 'c':
+            ConfereInterseccoes();
+        break;
+    case 'b':
+            ComparaTempos();
+        break;
     default:
         break;
     }
@@ -228,6 +298,8 @@ void mouseMove(int x, int y)
 int  main ( int argc, char** argv )
 {
     cout << "ARGC: " << argc << endl;
+    if (argc > 1)
+        nLinhas = max(1, atoi(argv[1])); // ex.: ./Interseccao 5000
     glutInit            ( &argc, argv );
     glutInitDisplayMode (GLUT_DOUBLE | GLUT_DEPTH | GLUT_RGB );
     glutInitWindowPosition (0,0);
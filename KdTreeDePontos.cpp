@@ -0,0 +1,309 @@
+//
+//  KdTreeDePontos.cpp
+//  OpenGLTest
+//
+
+#include <algorithm>
+#include "KdTreeDePontos.h"
+
+struct KdTreeDePontos::PontoIndexado
+{
+    float c[2];
+    int i;
+};
+
+KdTreeDePontos::KdTreeDePontos(int capacidadeDaFolha)
+{
+    CapacidadeDaFolha = max(1, capacidadeDaFolha);
+}
+
+void KdTreeDePontos::setCapacidadeDaFolha(int c)
+{
+    if (c >= 1)
+        CapacidadeDaFolha = c;
+}
+
+void KdTreeDePontos::Constroi(const vector<Ponto> &P)
+{
+    int n = (int)P.size();
+    // Particiona uma copia compacta: o nth_element nao precisa ir
+    // buscar as coordenadas no vetor original a cada comparacao
+    vector<PontoIndexado> Q(n);
+    for (int i = 0; i < n; i++)
+    {
+        Q[i].c[0] = P[i].x;
+        Q[i].c[1] = P[i].y;
+        Q[i].i = i;
+    }
+    Eixo.assign(n, 0);
+    Caixa = (n > 0) ? AABB::DosPontos(P.data(), n) : AABB();
+    divide(Q, 0, n, Caixa);
+
+    X.resize(n);
+    Y.resize(n);
+    Indices.resize(n);
+    for (int k = 0; k < n; k++)
+    {
+        X[k] = Q[k].c[0];
+        Y[k] = Q[k].c[1];
+        Indices[k] = Q[k].i;
+    }
+}
+
+void KdTreeDePontos::divide(vector<PontoIndexado> &P, int ini, int fim, AABB caixa)
+{
+    if (fim - ini <= CapacidadeDaFolha)
+        return;
+
+    int eixo = (caixa.maxX - caixa.minX >= caixa.maxY - caixa.minY) ? 0 : 1;
+    int m = (ini + fim) / 2;
+    nth_element(P.begin() + ini, P.begin() + m, P.begin() + fim,
+                [eixo](const PontoIndexado &A, const PontoIndexado &B) { return A.c[eixo] < B.c[eixo]; });
+    Eixo[m] = (unsigned char)eixo;
+
+    float corte = P[m].c[eixo];
+    AABB esquerda = caixa, direita = caixa;
+    if (eixo == 0)
+    {
+        esquerda.maxX = corte;
+        direita.minX = corte;
+    }
+    else
+    {
+        esquerda.maxY = corte;
+        direita.minY = corte;
+    }
+    divide(P, ini, m, esquerda);
+    divide(P, m + 1, fim, direita);
+}
+
+// ----------------------------------------------------------------------
+// Triangulo
+// ----------------------------------------------------------------------
+void KdTreeDePontos::PontosNoTriangulo(const TrianguloDeConsulta &T, vector<int> &Dentro,
+                                       ContadoresDaConsulta *Contadores) const
+{
+    Dentro.clear();
+    ContadoresDaConsulta C;
+    triangulo(0, (int)Indices.size(), Caixa, T, Dentro, C);
+    if (Contadores)
+    {
+        Contadores->NosVisitados += C.NosVisitados;
+        Contadores->PontosTestados += C.PontosTestados;
+        Contadores->PontosAceitosEmBloco += C.PontosAceitosEmBloco;
+    }
+}
+
+void KdTreeDePontos::triangulo(int ini, int fim, const AABB &caixa, const TrianguloDeConsulta &T,
+                               vector<int> &Dentro, ContadoresDaConsulta &C) const
+{
+    if (ini >= fim)
+        return;
+    C.NosVisitados++;
+    if (!T.intersectaCaixa(caixa))
+        return;
+    if (T.contemCaixa(caixa))
+    {
+        Dentro.insert(Dentro.end(), Indices.begin() + ini, Indices.begin() + fim);
+        C.PontosAceitosEmBloco += fim - ini;
+        return;
+    }
+    if (fim - ini <= CapacidadeDaFolha)
+    {
+        AcrescentaPontosNoTriangulo(&X[ini], &Y[ini], &Indices[ini], fim - ini, T, Dentro);
+        C.PontosTestados += fim - ini;
+        return;
+    }
+
+    int m = (ini + fim) / 2;
+    C.PontosTestados++;
+    if (T.contem(X[m], Y[m]))
+        Dentro.push_back(Indices[m]);
+
+    AABB esquerda = caixa, direita = caixa;
+    if (Eixo[m] == 0)
+        esquerda.maxX = direita.minX = X[m];
+    else
+        esquerda.maxY = direita.minY = Y[m];
+    triangulo(ini, m, esquerda, T, Dentro, C);
+    triangulo(m + 1, fim, direita, T, Dentro, C);
+}
+
+// ----------------------------------------------------------------------
+// k mais proximos
+// ----------------------------------------------------------------------
+// Heap guarda (distancia^2, indice original) com o pior candidato no
+// topo. O indice desempata distancias iguais, como na forca bruta.
+void KdTreeDePontos::MaisProximos(const Ponto &Q, int k, vector<int> &Vizinhos,
+                                  ContadoresDaConsulta *Contadores) const
+{
+    Vizinhos.clear();
+    if (k <= 0 || Indices.empty())
+        return;
+
+    vector<pair<float, int>> Heap;
+    Heap.reserve(k + 1);
+    ContadoresDaConsulta C;
+    vizinhos(0, (int)Indices.size(), Q.x, Q.y, k, Heap, C);
+
+    sort_heap(Heap.begin(), Heap.end());
+    for (const pair<float, int> &H : Heap)
+        Vizinhos.push_back(H.second);
+    if (Contadores)
+    {
+        Contadores->NosVisitados += C.NosVisitados;
+        Contadores->PontosTestados += C.PontosTestados;
+    }
+}
+
+void KdTreeDePontos::vizinhos(int ini, int fim, float qx, float qy, int k,
+                              vector<pair<float, int>> &Heap, ContadoresDaConsulta &C) const
+{
+    if (ini >= fim)
+        return;
+    C.NosVisitados++;
+
+    auto considera = [&](int j)
+    {
+        float dx = X[j] - qx, dy = Y[j] - qy;
+        pair<float, int> candidato(dx * dx + dy * dy, Indices[j]);
+        if ((int)Heap.size() < k)
+        {
+            Heap.push_back(candidato);
+            push_heap(Heap.begin(), Heap.end());
+        }
+        else if (candidato < Heap.front())
+        {
+            pop_heap(Heap.begin(), Heap.end());
+            Heap.back() = candidato;
+            push_heap(Heap.begin(), Heap.end());
+        }
+    };
+
+    if (fim - ini <= CapacidadeDaFolha)
+    {
+        for (int j = ini; j < fim; j++)
+            considera(j);
+        C.PontosTestados += fim - ini;
+        return;
+    }
+
+    int m = (ini + fim) / 2;
+    considera(m);
+    C.PontosTestados++;
+
+    // Primeiro o lado de Q; o outro so se o plano de corte estiver mais
+    // perto que o pior candidato
+    float diferenca = (Eixo[m] == 0) ? qx - X[m] : qy - Y[m];
+    if (diferenca < 0)
+        vizinhos(ini, m, qx, qy, k, Heap, C);
+    else
+        vizinhos(m + 1, fim, qx, qy, k, Heap, C);
+    if ((int)Heap.size() < k || diferenca * diferenca <= Heap.front().first)
+    {
+        if (diferenca < 0)
+            vizinhos(m + 1, fim, qx, qy, k, Heap, C);
+        else
+            vizinhos(ini, m, qx, qy, k, Heap, C);
+    }
+}
+
+// ----------------------------------------------------------------------
+// Raio
+// ----------------------------------------------------------------------
+void KdTreeDePontos::PontosNoRaio(const Ponto &Q, float r, vector<int> &Dentro,
+                                  ContadoresDaConsulta *Contadores) const
+{
+    Dentro.clear();
+    if (r < 0)
+        return;
+    ContadoresDaConsulta C;
+    raio(0, (int)Indices.size(), Caixa, Q.x, Q.y, r * r, Dentro, C);
+    if (Contadores)
+    {
+        Contadores->NosVisitados += C.NosVisitados;
+        Contadores->PontosTestados += C.PontosTestados;
+        Contadores->PontosAceitosEmBloco += C.PontosAceitosEmBloco;
+    }
+}
+
+void KdTreeDePontos::raio(int ini, int fim, const AABB &caixa, float qx, float qy, float r2,
+                          vector<int> &Dentro, ContadoresDaConsulta &C) const
+{
+    if (ini >= fim)
+        return;
+    C.NosVisitados++;
+
+    // Ponto da caixa mais perto de Q e canto mais longe
+    float px = max(caixa.minX, min(qx, caixa.maxX));
+    float py = max(caixa.minY, min(qy, caixa.maxY));
+    float perto = (px - qx) * (px - qx) + (py - qy) * (py - qy);
+    if (perto > r2)
+        return;
+    float lx = max(qx - caixa.minX, caixa.maxX - qx);
+    float ly = max(qy - caixa.minY, caixa.maxY - qy);
+    if (lx * lx + ly * ly <= r2)
+    {
+        Dentro.insert(Dentro.end(), Indices.begin() + ini, Indices.begin() + fim);
+        C.PontosAceitosEmBloco += fim - ini;
+        return;
+    }
+
+    auto testa = [&](int j)
+    {
+        float dx = X[j] - qx, dy = Y[j] - qy;
+        if (dx * dx + dy * dy <= r2)
+            Dentro.push_back(Indices[j]);
+    };
+
+    if (fim - ini <= CapacidadeDaFolha)
+    {
+        for (int j = ini; j < fim; j++)
+            testa(j);
+        C.PontosTestados += fim - ini;
+        return;
+    }
+
+    int m = (ini + fim) / 2;
+    testa(m);
+    C.PontosTestados++;
+
+    AABB esquerda = caixa, direita = caixa;
+    if (Eixo[m] == 0)
+        esquerda.maxX = direita.minX = X[m];
+    else
+        esquerda.maxY = direita.minY = Y[m];
+    raio(ini, m, esquerda, qx, qy, r2, Dentro, C);
+    raio(m + 1, fim, direita, qx, qy, r2, Dentro, C);
+}
+
+// ----------------------------------------------------------------------
+// Forca bruta
+// ----------------------------------------------------------------------
+void MaisProximosForcaBruta(const vector<Ponto> &Pontos, const Ponto &Q, int k, vector<int> &Vizinhos)
+{
+    int n = (int)Pontos.size();
+    k = max(0, min(k, n));
+    vector<pair<float, int>> D(n);
+    for (int i = 0; i < n; i++)
+    {
+        float dx = Pontos[i].x - Q.x, dy = Pontos[i].y - Q.y;
+        D[i] = make_pair(dx * dx + dy * dy, i);
+    }
+    partial_sort(D.begin(), D.begin() + k, D.end());
+    Vizinhos.resize(k);
+    for (int i = 0; i < k; i++)
+        Vizinhos[i] = D[i].second;
+}
+
+void PontosNoRaioForcaBruta(const vector<Ponto> &Pontos, const Ponto &Q, float r, vector<int> &Dentro)
+{
+    Dentro.clear();
+    float r2 = r * r;
+    for (int i = 0; i < (int)Pontos.size(); i++)
+    {
+        float dx = Pontos[i].x - Q.x, dy = Pontos[i].y - Q.y;
+        if (dx * dx + dy * dy <= r2)
+            Dentro.push_back(i);
+    }
+}
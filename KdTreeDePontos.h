@@ -0,0 +1,81 @@
+//
+//  KdTreeDePontos.h
+//  OpenGLTest
+//
+//  Arvore kd de pontos 2D, guardada num vetor plano sem nos alocados.
+//  O intervalo [ini, fim) de pontos eh dividido pela mediana m =
+//  (ini+fim)/2 (nth_element) no eixo em que a regiao eh mais larga: o
+//  ponto da mediana fica em m, os menores em [ini, m) e os maiores em
+//  [m+1, fim). Os filhos sao os dois intervalos, entao a arvore inteira
+//  eh so o vetor de pontos reordenado mais o eixo de corte de cada
+//  mediana. A construcao eh O(n log n).
+//
+//  Intervalos com ate CapacidadeDaFolha pontos nao sao divididos.
+//  A caixa de cada no nao eh guardada: eh calculada na descida, cortando
+//  a caixa do pai na coordenada da mediana.
+//
+//  Consultas:
+//   - pontos dentro de um triangulo (poda e aceite em bloco, como na
+//     QuadTreeDePontos);
+//   - os k pontos mais proximos de um ponto;
+//   - os pontos a ate uma distancia r de um ponto.
+//
+
+#ifndef KdTreeDePontos_hpp
+#define KdTreeDePontos_hpp
+
+#include <vector>
+using namespace std;
+
+#include "Ponto.h"
+#include "AABB.h"
+#include "TrianguloDeConsulta.h"
+
+class KdTreeDePontos
+{
+    vector<float> X, Y;        // pontos na ordem da arvore
+    vector<int> Indices;       // posicao de cada ponto no vetor original
+    vector<unsigned char> Eixo; // eixo de corte (0: x, 1: y) de cada mediana
+    AABB Caixa;                // caixa envolvente de todos os pontos
+    int CapacidadeDaFolha;
+
+    struct PontoIndexado;
+    void divide(vector<PontoIndexado> &P, int ini, int fim, AABB caixa);
+
+    // Descidas recursivas; contadores locais somados no fim de cada consulta
+    void triangulo(int ini, int fim, const AABB &caixa, const TrianguloDeConsulta &T,
+                   vector<int> &Dentro, ContadoresDaConsulta &C) const;
+    void vizinhos(int ini, int fim, float qx, float qy, int k,
+                  vector<pair<float, int>> &Heap, ContadoresDaConsulta &C) const;
+    void raio(int ini, int fim, const AABB &caixa, float qx, float qy, float r2,
+              vector<int> &Dentro, ContadoresDaConsulta &C) const;
+public:
+    KdTreeDePontos(int capacidadeDaFolha = 8);
+
+    // Vale a partir da proxima construcao
+    void setCapacidadeDaFolha(int c);
+    int getCapacidadeDaFolha() const { return CapacidadeDaFolha; }
+
+    void Constroi(const vector<Ponto> &P);
+    int getNroDePontos() const { return (int)Indices.size(); }
+
+    // Indices (no vetor original) dos pontos dentro ou na borda do
+    // triangulo, sem ordem definida
+    void PontosNoTriangulo(const TrianguloDeConsulta &T, vector<int> &Dentro,
+                           ContadoresDaConsulta *Contadores = nullptr) const;
+
+    // Os k pontos mais proximos de Q, do mais proximo para o mais
+    // distante (menos de k se a arvore tem menos pontos)
+    void MaisProximos(const Ponto &Q, int k, vector<int> &Vizinhos,
+                      ContadoresDaConsulta *Contadores = nullptr) const;
+
+    // Pontos a distancia <= r de Q, sem ordem definida
+    void PontosNoRaio(const Ponto &Q, float r, vector<int> &Dentro,
+                      ContadoresDaConsulta *Contadores = nullptr) const;
+};
+
+// Versoes por forca bruta, usadas como referencia
+void MaisProximosForcaBruta(const vector<Ponto> &Pontos, const Ponto &Q, int k, vector<int> &Vizinhos);
+void PontosNoRaioForcaBruta(const vector<Ponto> &Pontos, const Ponto &Q, float r, vector<int> &Dentro);
+
+#endif /* KdTreeDePontos_hpp */
@@ -0,0 +1,446 @@
+//
+//  LeitorDePoligonos.cpp
+//  OpenGLTest
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <clocale>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "LeitorDePoligonos.h"
+
+// **********************************************************************
+//  ArquivoMapeado
+// **********************************************************************
+ArquivoMapeado::ArquivoMapeado()
+{
+    Dados = NULL;
+    Tamanho = 0;
+    Mapeamento = NULL;
+}
+
+ArquivoMapeado::~ArquivoMapeado()
+{
+    fecha();
+}
+
+void ArquivoMapeado::fecha()
+{
+#ifndef _WIN32
+    if (Mapeamento != NULL)
+        munmap(Mapeamento, Tamanho);
+#endif
+    Mapeamento = NULL;
+    Buffer.clear();
+    Dados = NULL;
+    Tamanho = 0;
+}
+
+bool ArquivoMapeado::abre(const char *nome)
+{
+    fecha();
+#ifdef _WIN32
+    FILE *f = fopen(nome, "rb");
+    if (f == NULL)
+        return false;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    Buffer.resize(n > 0 ? n : 0);
+    size_t lidos = n > 0 ? fread(&Buffer[0], 1, n, f) : 0;
+    fclose(f);
+    Tamanho = lidos;
+    Dados = Buffer.empty() ? "" : &Buffer[0];
+    return true;
+#else
+    int fd = open(nome, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    Tamanho = (size_t)st.st_size;
+    if (Tamanho == 0) // mmap nao aceita tamanho zero
+    {
+        close(fd);
+        Dados = "";
+        return true;
+    }
+    void *m = mmap(NULL, Tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // o mapeamento continua valido
+    if (m == MAP_FAILED)
+    {
+        Tamanho = 0;
+        return false;
+    }
+    madvise(m, Tamanho, MADV_SEQUENTIAL);
+    Mapeamento = m;
+    Dados = (const char *)m;
+    return true;
+#endif
+}
+
+// **********************************************************************
+//  Conversao de numeros
+// **********************************************************************
+
+// Potencias de 10 exatas em double (ate 10^22)
+static const double Pot10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline bool EhDigito(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Caminho lento: copia o texto e usa strtod. So eh usado para numeros
+// com mais de 19 digitos significativos ou expoentes grandes. Os
+// numeros aceitos aqui nao tem separador de milhar nem virgula, entao
+// o resultado so depende do locale se ele trocar o '.', o que eh
+// tratado trocando '.' pelo separador do locale atual.
+static double ConverteComStrtod(const char *ini, const char *fim)
+{
+    char tmp[128];
+    size_t n = (size_t)(fim - ini);
+    if (n >= sizeof(tmp))
+        n = sizeof(tmp) - 1;
+    memcpy(tmp, ini, n);
+    tmp[n] = '\0';
+    char sep = *localeconv()->decimal_point;
+    if (sep != '.')
+        for (size_t k = 0; k < n; k++)
+            if (tmp[k] == '.')
+                tmp[k] = sep;
+    return strtod(tmp, NULL);
+}
+
+bool ConverteNumero(const char *&p, const char *fim, double &v)
+{
+    const char *ini = p;
+    const char *q = p;
+    bool negativo = false;
+    if (q < fim && (*q == '-' || *q == '+'))
+    {
+        negativo = (*q == '-');
+        q++;
+    }
+
+    unsigned long long mantissa = 0;
+    int nDigitos = 0;     // digitos significativos acumulados em "mantissa"
+    int expDecimal = 0;   // expoente a aplicar na mantissa
+    bool temDigito = false;
+
+    while (q < fim && *q == '0') // zeros a esquerda nao contam
+    {
+        q++;
+        temDigito = true;
+    }
+    for (; q < fim && EhDigito(*q); q++)
+    {
+        temDigito = true;
+        if (nDigitos < 19)
+        {
+            mantissa = mantissa * 10 + (unsigned)(*q - '0');
+            nDigitos++;
+        }
+        else
+            expDecimal++; // digito perdido: so muda a escala
+    }
+    if (q < fim && *q == '.')
+    {
+        q++;
+        if (mantissa == 0)
+            while (q < fim && *q == '0')
+            {
+                q++;
+                expDecimal--;
+                temDigito = true;
+            }
+        for (; q < fim && EhDigito(*q); q++)
+        {
+            temDigito = true;
+            if (nDigitos < 19)
+            {
+                mantissa = mantissa * 10 + (unsigned)(*q - '0');
+                nDigitos++;
+                expDecimal--;
+            }
+        }
+    }
+    if (!temDigito)
+        return false;
+
+    if (q < fim && (*q == 'e' || *q == 'E'))
+    {
+        const char *r = q + 1;
+        bool expNegativo = false;
+        if (r < fim && (*r == '-' || *r == '+'))
+        {
+            expNegativo = (*r == '-');
+            r++;
+        }
+        if (r < fim && EhDigito(*r))
+        {
+            int e = 0;
+            for (; r < fim && EhDigito(*r); r++)
+                if (e < 100000)
+                    e = e * 10 + (*r - '0');
+            expDecimal += expNegativo ? -e : e;
+            q = r;
+        }
+    }
+
+    // O numero tem que terminar num separador
+    if (q < fim && !(*q == ' ' || *q == '\t' || *q == '\n' || *q == '\r'))
+        return false;
+
+    // Caminho rapido (Clinger): mantissa e 10^|e| exatos em double,
+    // entao uma unica multiplicacao/divisao ja da o valor arredondado
+    double r;
+    if (mantissa == 0)
+        r = 0.0;
+    else if (mantissa < (1ull << 53) && expDecimal >= -22 && expDecimal <= 22)
+    {
+        r = (double)mantissa;
+        r = (expDecimal < 0) ? r / Pot10[-expDecimal] : r * Pot10[expDecimal];
+    }
+    else
+        r = fabs(ConverteComStrtod(ini, q));
+
+    v = negativo ? -r : r;
+    p = q;
+    return true;
+}
+
+// **********************************************************************
+//  Leitura do arquivo
+// **********************************************************************
+
+// Pula espacos e tabulacoes (nao pula o fim da linha)
+static inline void PulaBrancos(const char *&p, const char *fim)
+{
+    while (p < fim && (*p == ' ' || *p == '\t' || *p == '\r'))
+        p++;
+}
+
+static inline void PulaLinhasVazias(const char *&p, const char *fim, long &linha)
+{
+    for (;;)
+    {
+        PulaBrancos(p, fim);
+        if (p < fim && *p == '\n')
+        {
+            p++;
+            linha++;
+        }
+        else
+            return;
+    }
+}
+
+static string ErroNaLinha(const char *nome, long linha, const char *msg)
+{
+    ostringstream s;
+    s << nome << ":" << linha << ": " << msg;
+    return s.str();
+}
+
+ResultadoDaLeitura LeVerticesDoArquivo(const char *nome, vector<Ponto> &V, string &erro)
+{
+    V.clear();
+    ArquivoMapeado arq;
+    if (!arq.abre(nome))
+    {
+        erro = string("Erro ao abrir ") + nome + ".";
+        return LEITURA_SEM_ARQUIVO;
+    }
+    const char *p = arq.dados();
+    const char *fim = p + arq.tamanho();
+    long linha = 1;
+
+    PulaLinhasVazias(p, fim, linha);
+    double qtd;
+    if (!ConverteNumero(p, fim, qtd) || !(qtd >= 0) || qtd != floor(qtd))
+    {
+        erro = ErroNaLinha(nome, linha, "esperada a quantidade de vertices");
+        return LEITURA_MAL_FORMADO;
+    }
+    // O cabecalho pode mentir; cada vertice ocupa pelo menos 4 bytes
+    // ("0 0\n"), entao o arquivo nao comporta mais que maxVertices. Uma
+    // quantidade maior (1e30 nem cabe num long) eh limitada a
+    // maxVertices + 1: os vertices sao lidos mesmo assim e o arquivo
+    // termina antes, com o erro abaixo.
+    long maxVertices = (long)(arq.tamanho() / 4 + 1);
+    long qtdVertices = (qtd > (double)maxVertices) ? maxVertices + 1 : (long)qtd;
+    V.reserve((size_t)min(qtdVertices, maxVertices));
+
+    for (long i = 0; i < qtdVertices; i++)
+    {
+        PulaBrancos(p, fim);
+        if (p < fim && *p == '\n')
+        {
+            p++;
+            linha++;
+        }
+        PulaLinhasVazias(p, fim, linha);
+        if (p >= fim)
+        {
+            ostringstream s;
+            s << "o arquivo terminou apos " << i << " de " << fixed << setprecision(0) << qtd << " vertices";
+            erro = ErroNaLinha(nome, linha, s.str().c_str());
+            return LEITURA_MAL_FORMADO;
+        }
+        double x, y;
+        if (!ConverteNumero(p, fim, x))
+        {
+            erro = ErroNaLinha(nome, linha, "coordenada x invalida");
+            return LEITURA_MAL_FORMADO;
+        }
+        PulaBrancos(p, fim);
+        if (p >= fim || *p == '\n' || !ConverteNumero(p, fim, y))
+        {
+            erro = ErroNaLinha(nome, linha, "coordenada y invalida ou ausente");
+            return LEITURA_MAL_FORMADO;
+        }
+        PulaBrancos(p, fim);
+        if (p < fim && *p != '\n')
+        {
+            erro = ErroNaLinha(nome, linha, "texto a mais depois das coordenadas");
+            return LEITURA_MAL_FORMADO;
+        }
+        V.push_back(Ponto((float)x, (float)y));
+    }
+    return LEITURA_OK;
+}
+
+// **********************************************************************
+//  Cache binario
+// **********************************************************************
+static bool ObtemTamanhoEData(const char *nome, uint64_t &tamanho, int64_t &data)
+{
+    struct stat st;
+    if (stat(nome, &st) != 0)
+        return false;
+    tamanho = (uint64_t)st.st_size;
+    // Em nanossegundos: com segundos, duas gravacoes no mesmo segundo
+    // com o mesmo tamanho deixariam o cache velho passar
+#if defined(__APPLE__)
+    data = (int64_t)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+    data = (int64_t)st.st_mtime * 1000000000;
+#else
+    data = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+    return true;
+}
+
+string NomeDoCache(const char *nome)
+{
+    return string(nome) + ".pbin";
+}
+
+bool LeCacheDoPoligono(const char *nome, vector<Ponto> &V, Ponto &Min, Ponto &Max)
+{
+    uint64_t tamanho;
+    int64_t data;
+    if (!ObtemTamanhoEData(nome, tamanho, data))
+        return false;
+
+    ArquivoMapeado arq;
+    if (!arq.abre(NomeDoCache(nome).c_str()))
+        return false;
+    if (arq.tamanho() < sizeof(CabecalhoDoCache))
+        return false;
+
+    CabecalhoDoCache C;
+    memcpy(&C, arq.dados(), sizeof(C));
+    if (memcmp(C.Assinatura, "PBIN", 4) != 0 || C.Marca != MARCA_DO_CACHE ||
+        C.Versao != VERSAO_DO_CACHE || C.Precisao != sizeof(float))
+        return false;
+    if (C.TamanhoOrigem != tamanho || C.DataOrigem != data)
+        return false; // o texto mudou depois que o cache foi gravado
+    // Compara antes de multiplicar: um NVertices corrompido estouraria a conta
+    if (C.NVertices > (arq.tamanho() - sizeof(C)) / (2 * sizeof(float)) ||
+        arq.tamanho() != sizeof(C) + 2 * C.NVertices * sizeof(float))
+        return false;
+
+    // Os vetores ficam logo depois do cabecalho (alinhados a 4 bytes)
+    const float *xs = (const float *)(arq.dados() + sizeof(C));
+    const float *ys = xs + C.NVertices;
+    V.clear();
+    V.reserve((size_t)C.NVertices);
+    for (uint64_t i = 0; i < C.NVertices; i++)
+        V.push_back(Ponto(xs[i], ys[i]));
+    Min = Ponto(C.MinX, C.MinY);
+    Max = Ponto(C.MaxX, C.MaxY);
+    return true;
+}
+
+bool GravaCacheDoPoligono(const char *nome, const vector<Ponto> &V)
+{
+    CabecalhoDoCache C;
+    memset(&C, 0, sizeof(C));
+    memcpy(C.Assinatura, "PBIN", 4);
+    C.Marca = MARCA_DO_CACHE;
+    C.Versao = VERSAO_DO_CACHE;
+    C.Precisao = sizeof(float);
+    if (!ObtemTamanhoEData(nome, C.TamanhoOrigem, C.DataOrigem))
+        return false;
+    C.NVertices = V.size();
+    if (!V.empty())
+    {
+        C.MinX = C.MaxX = V[0].x;
+        C.MinY = C.MaxY = V[0].y;
+    }
+    vector<float> coords(2 * V.size());
+    for (size_t i = 0; i < V.size(); i++)
+    {
+        coords[i] = V[i].x;
+        coords[V.size() + i] = V[i].y;
+        C.MinX = min(C.MinX, V[i].x);
+        C.MinY = min(C.MinY, V[i].y);
+        C.MaxX = max(C.MaxX, V[i].x);
+        C.MaxY = max(C.MaxY, V[i].y);
+    }
+
+    // Grava num temporario e renomeia, para que outra execucao nunca
+    // veja um cache pela metade
+    string final = NomeDoCache(nome);
+    string temp = final + ".tmp";
+    FILE *f = fopen(temp.c_str(), "wb");
+    if (f == NULL)
+        return false;
+    bool ok = fwrite(&C, sizeof(C), 1, f) == 1;
+    if (ok && !coords.empty())
+        ok = fwrite(&coords[0], sizeof(float), coords.size(), f) == coords.size();
+    ok = (fclose(f) == 0) && ok;
+    if (ok)
+    {
+#ifdef _WIN32
+        remove(final.c_str()); // no Windows rename nao sobrescreve
+#endif
+        ok = rename(temp.c_str(), final.c_str()) == 0;
+    }
+    if (!ok)
+        remove(temp.c_str());
+    return ok;
+}
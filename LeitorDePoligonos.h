@@ -0,0 +1,105 @@
+//
+//  LeitorDePoligonos.h
+//  OpenGLTest
+//
+//  Leitura rapida de arquivos de poligonos no formato texto:
+//
+//      <quantidade de vertices>
+//      x y
+//      x y
+//      ...
+//
+//  O arquivo eh mapeado na memoria (mmap) e os numeros sao
+//  convertidos por um conversor proprio, que nao depende do locale
+//  (sempre usa '.' como separador decimal). O vetor de vertices eh
+//  reservado a partir da quantidade informada no cabecalho.
+//
+//  Para nao converter o texto a cada execucao, a primeira leitura de
+//  um arquivo grava ao lado dele um cache binario (<nome>.pbin):
+//
+//      CabecalhoDoCache
+//      float x[n]
+//      float y[n]
+//
+//  O cache guarda o tamanho e a data de modificacao do texto; se
+//  algum dos dois mudar, ele eh descartado e gravado de novo.
+//
+
+#ifndef LeitorDePoligonos_hpp
+#define LeitorDePoligonos_hpp
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+using namespace std;
+
+#include "Ponto.h"
+
+// Arquivo somente-leitura mapeado na memoria. Onde nao ha mmap
+// (Windows), o conteudo eh lido para um buffer.
+class ArquivoMapeado
+{
+    const char *Dados;
+    size_t Tamanho;
+    void *Mapeamento; // regiao do mmap, ou NULL
+    vector<char> Buffer;
+
+    ArquivoMapeado(const ArquivoMapeado &);            // nao copiavel
+    ArquivoMapeado &operator=(const ArquivoMapeado &);
+public:
+    ArquivoMapeado();
+    ~ArquivoMapeado();
+
+    bool abre(const char *nome); // false se nao conseguiu abrir/mapear
+    void fecha();
+
+    const char *dados() const { return Dados; }
+    size_t tamanho() const { return Tamanho; }
+};
+
+// Converte o numero que comeca em p (sem espacos antes). Em caso de
+// sucesso guarda o valor em v, avanca p e retorna true.
+bool ConverteNumero(const char *&p, const char *fim, double &v);
+
+enum ResultadoDaLeitura
+{
+    LEITURA_OK,
+    LEITURA_SEM_ARQUIVO, // nao conseguiu abrir o arquivo
+    LEITURA_MAL_FORMADO  // alguma linha com erro; "erro" diz qual
+};
+
+// Le os vertices do arquivo. Em caso de linha mal formada, "erro"
+// descreve o problema (com o numero da linha) e V fica com os
+// vertices lidos ate ali.
+ResultadoDaLeitura LeVerticesDoArquivo(const char *nome, vector<Ponto> &V, string &erro);
+
+// Cabecalho do cache binario. Todos os campos tem tamanho fixo e
+// o arquivo eh gravado na ordem de bytes da maquina; a marca
+// detecta um cache vindo de uma maquina com outra ordem.
+struct CabecalhoDoCache
+{
+    char Assinatura[4];     // "PBIN"
+    uint32_t Marca;         // MARCA_DO_CACHE
+    uint32_t Versao;
+    uint32_t Precisao;      // bytes por coordenada (sizeof(float))
+    uint64_t TamanhoOrigem; // tamanho do .txt em bytes
+    int64_t DataOrigem;     // mtime do .txt, em nanossegundos
+    uint64_t NVertices;
+    float MinX, MinY, MaxX, MaxY;
+};
+
+const uint32_t MARCA_DO_CACHE = 0x01020304;
+const uint32_t VERSAO_DO_CACHE = 2;
+
+// Nome do cache de um arquivo texto
+string NomeDoCache(const char *nome);
+
+// Le o cache de "nome" (o .txt), se existir e estiver em dia.
+// Retorna false se o cache nao existe, esta velho ou corrompido.
+bool LeCacheDoPoligono(const char *nome, vector<Ponto> &V, Ponto &Min, Ponto &Max);
+
+// Grava o cache de "nome". Retorna false se nao conseguiu (por
+// exemplo, diretorio sem permissao de escrita).
+bool GravaCacheDoPoligono(const char *nome, const vector<Ponto> &V);
+
+#endif /* LeitorDePoligonos_hpp */
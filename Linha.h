@@ -1,3 +1,5 @@
+#ifndef Linha_hpp
+#define Linha_hpp
 
 #ifdef WIN32
 #include <windows.h>
@@ -9,6 +11,10 @@
 #include <GLUT/glut.h>
 #endif
 
+#ifdef __linux__
+#include <GL/glut.h>
+#endif
+
 //#include "Ponto.h"
 
 class Linha {
@@ -21,3 +27,5 @@ public:
 	void desenhaLinha();
 
 };
+
+#endif
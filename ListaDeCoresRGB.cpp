@@ -112,4 +112,11 @@ void defineCor(int c)
     glColor3f(Cores[c][0], Cores[c][1], Cores[c][2]);
 }
 
+void obtemCor(int c, float &r, float &g, float &b)
+{
+    r = Cores[c][0];
+    g = Cores[c][1];
+    b = Cores[c][2];
+}
+
 						
@@ -132,5 +132,6 @@ enum Cores {
 
 
 void defineCor(int c);
+void obtemCor(int c, float &r, float &g, float &b); // componentes da cor c
 
 #endif
@@ -1,5 +1,5 @@
 PROG    := BasicoOpenGL.exe
-SRC     := Ponto.cpp Poligono.cpp Temporizador.cpp ListaDeCoresRGB.cpp Instancia.cpp ModeloMatricial.cpp TransformacoesGeometricas.cpp
+SRC     := Ponto.cpp Poligono.cpp BufferDeVertices.cpp Triangulacao.cpp Temporizador.cpp ListaDeCoresRGB.cpp Instancia.cpp ModeloMatricial.cpp GradeEspacial.cpp ArvoreAABB.cpp Colisao.cpp Entidades.cpp Matriz2D.cpp ModeloCompilado.cpp LeitorDePoligonos.cpp TransformacoesGeometricas.cpp
 OBJS    := $(SRC:.cpp=.o)
 
 CXX     := g++
@@ -0,0 +1,125 @@
+//
+//  Matriz2D.cpp
+//  OpenGLTest
+//
+
+#include "Matriz2D.h"
+
+Matriz2D::Matriz2D()
+{
+    a = 1; b = 0; tx = 0;
+    c = 0; d = 1; ty = 0;
+}
+
+Matriz2D Matriz2D::Translacao(float x, float y)
+{
+    Matriz2D M;
+    M.tx = x;
+    M.ty = y;
+    return M;
+}
+
+Matriz2D Matriz2D::Rotacao(float angulo)
+{
+    double anguloRad = angulo * 3.14159265359/180.0;
+    float co = (float)cos(anguloRad);
+    float si = (float)sin(anguloRad);
+    Matriz2D M;
+    M.a = co; M.b = -si;
+    M.c = si; M.d = co;
+    return M;
+}
+
+Matriz2D Matriz2D::Escala(float sx, float sy)
+{
+    Matriz2D M;
+    M.a = sx;
+    M.d = sy;
+    return M;
+}
+
+Matriz2D Matriz2D::operator*(const Matriz2D &B) const
+{
+    Matriz2D R;
+    R.a  = a * B.a + b * B.c;
+    R.b  = a * B.b + b * B.d;
+    R.tx = a * B.tx + b * B.ty + tx;
+    R.c  = c * B.a + d * B.c;
+    R.d  = c * B.b + d * B.d;
+    R.ty = c * B.tx + d * B.ty + ty;
+    return R;
+}
+
+Ponto Matriz2D::aplica(const Ponto &P) const
+{
+    return Ponto(a * P.x + b * P.y + tx, c * P.x + d * P.y + ty, P.z);
+}
+
+Ponto Matriz2D::aplicaVetor(const Ponto &V) const
+{
+    return Ponto(a * V.x + b * V.y, c * V.x + d * V.y, V.z);
+}
+
+void Matriz2D::paraOpenGL(float M[16]) const
+{
+    M[0] = a;  M[4] = b;  M[8]  = 0; M[12] = tx;
+    M[1] = c;  M[5] = d;  M[9]  = 0; M[13] = ty;
+    M[2] = 0;  M[6] = 0;  M[10] = 1; M[14] = 0;
+    M[3] = 0;  M[7] = 0;  M[11] = 0; M[15] = 1;
+}
+
+Matriz2D MatrizDeInstanciamento(const Ponto &Posicao, const Ponto &Pivot,
+                                float Rotacao, const Ponto &Escala)
+{
+    // T(Posicao) * T(Pivot) * R * S * T(-Pivot), ja multiplicado
+    Matriz2D RS = Matriz2D::Rotacao(Rotacao) * Matriz2D::Escala(Escala.x, Escala.y);
+    RS.tx = Posicao.x + Pivot.x - (RS.a * Pivot.x + RS.b * Pivot.y);
+    RS.ty = Posicao.y + Pivot.y - (RS.c * Pivot.x + RS.d * Pivot.y);
+    return RS;
+}
+
+PilhaDeMatrizes::PilhaDeMatrizes()
+{
+    Pilha.push_back(Matriz2D());
+}
+
+void PilhaDeMatrizes::empilha()
+{
+    Pilha.push_back(Pilha.back());
+}
+
+void PilhaDeMatrizes::desempilha()
+{
+    if (Pilha.size() > 1)
+        Pilha.pop_back();
+}
+
+const Matriz2D &PilhaDeMatrizes::topo() const
+{
+    return Pilha.back();
+}
+
+void PilhaDeMatrizes::carregaIdentidade()
+{
+    Pilha.back() = Matriz2D();
+}
+
+void PilhaDeMatrizes::multiplica(const Matriz2D &M)
+{
+    Pilha.back() = Pilha.back() * M;
+}
+
+void PilhaDeMatrizes::translada(float x, float y)
+{
+    multiplica(Matriz2D::Translacao(x, y));
+}
+
+void PilhaDeMatrizes::rotaciona(float angulo)
+{
+    multiplica(Matriz2D::Rotacao(angulo));
+}
+
+void PilhaDeMatrizes::escala(float sx, float sy)
+{
+    multiplica(Matriz2D::Escala(sx, sy));
+}
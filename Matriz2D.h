@@ -0,0 +1,71 @@
+//
+//  Matriz2D.h
+//  OpenGLTest
+//
+//  Matriz afim 3x3 (2D) e pilha de matrizes calculadas na CPU.
+//  Reproduzem as chamadas glTranslatef/glRotatef/glScalef sobre o eixo
+//  Z, de modo que posicoes no mundo (SRU) e cantos de envelopes possam
+//  ser obtidos sem consultar o OpenGL (glGetFloatv forca o driver a
+//  esperar o fim do desenho). A mesma matriz pode ser passada ao
+//  OpenGL com glMultMatrixf, via paraOpenGL().
+//
+//  A ultima linha da matriz eh sempre (0 0 1) e nao eh guardada:
+//      | a  b  tx |
+//      | c  d  ty |
+//      | 0  0  1  |
+//
+
+#ifndef Matriz2D_hpp
+#define Matriz2D_hpp
+
+#include <vector>
+using namespace std;
+
+#include "Ponto.h"
+
+class Matriz2D
+{
+public:
+    float a, b, tx;
+    float c, d, ty;
+
+    Matriz2D(); // identidade
+
+    static Matriz2D Translacao(float x, float y);
+    static Matriz2D Rotacao(float angulo); // em graus, como glRotatef(angulo, 0,0,1)
+    static Matriz2D Escala(float sx, float sy);
+
+    // Composicao: (A*B).aplica(P) == A.aplica(B.aplica(P))
+    Matriz2D operator*(const Matriz2D &B) const;
+
+    Ponto aplica(const Ponto &P) const;       // transforma um ponto
+    Ponto aplicaVetor(const Ponto &V) const;  // transforma uma direcao (sem translacao)
+
+    // Matriz 4x4 em ordem de colunas, para glLoadMatrixf/glMultMatrixf
+    void paraOpenGL(float M[16]) const;
+};
+
+// Transformacao de instanciamento: translada para Posicao e aplica
+// rotacao e escala ao redor do Pivot, na mesma ordem de Instancia::desenha
+Matriz2D MatrizDeInstanciamento(const Ponto &Posicao, const Ponto &Pivot,
+                                float Rotacao, const Ponto &Escala);
+
+// Pilha no estilo glPushMatrix/glPopMatrix
+class PilhaDeMatrizes
+{
+    vector<Matriz2D> Pilha;
+public:
+    PilhaDeMatrizes(); // comeca com a identidade
+
+    void empilha();    // duplica o topo
+    void desempilha();
+    const Matriz2D &topo() const;
+
+    void carregaIdentidade();
+    void multiplica(const Matriz2D &M); // topo = topo * M
+    void translada(float x, float y);
+    void rotaciona(float angulo);
+    void escala(float sx, float sy);
+};
+
+#endif /* Matriz2D_hpp */
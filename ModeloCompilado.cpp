@@ -0,0 +1,157 @@
+//
+//  ModeloCompilado.cpp
+//  OpenGLTest
+//
+
+#include <cmath>
+#include "ModeloCompilado.h"
+
+static inline VerticeColorido Vertice(float x, float y, const float cor[3])
+{
+    VerticeColorido v;
+    v.x = x;
+    v.y = y;
+    v.r = cor[0];
+    v.g = cor[1];
+    v.b = cor[2];
+    return v;
+}
+
+ModeloCompilado::ModeloCompilado()
+{
+    Lista = 0;
+}
+
+void ModeloCompilado::limpa()
+{
+    Triangulos.clear();
+    Linhas.clear();
+    if (Lista != 0)
+    {
+        glDeleteLists(Lista, 1);
+        Lista = 0;
+    }
+}
+
+void ModeloCompilado::adicionaCelula(int i, int j, const float corInterna[3], const float corBorda[3])
+{
+    float x0 = (float)j, y0 = (float)i;
+    float x1 = x0 + 1, y1 = y0 + 1;
+
+    // dois triangulos
+    Triangulos.push_back(Vertice(x0, y0, corInterna));
+    Triangulos.push_back(Vertice(x0, y1, corInterna));
+    Triangulos.push_back(Vertice(x1, y1, corInterna));
+    Triangulos.push_back(Vertice(x0, y0, corInterna));
+    Triangulos.push_back(Vertice(x1, y1, corInterna));
+    Triangulos.push_back(Vertice(x1, y0, corInterna));
+
+    // quatro arestas
+    const float P[5][2] = {{x0,y0}, {x0,y1}, {x1,y1}, {x1,y0}, {x0,y0}};
+    for (int k = 0; k < 4; k++)
+    {
+        Linhas.push_back(Vertice(P[k][0], P[k][1], corBorda));
+        Linhas.push_back(Vertice(P[k+1][0], P[k+1][1], corBorda));
+    }
+}
+
+void ModeloCompilado::adicionaDisco(float cx, float cy, float r, int n, const float corInterna[3], const float corBorda[3])
+{
+    const float PI_F = 3.14159265358979323846f;
+    for (int k = 0; k < n; k++)
+    {
+        float a0 = (2.0f * PI_F * k) / n;
+        float a1 = (2.0f * PI_F * (k + 1)) / n;
+        VerticeColorido p0 = Vertice(cx + r * cosf(a0), cy + r * sinf(a0), corInterna);
+        VerticeColorido p1 = Vertice(cx + r * cosf(a1), cy + r * sinf(a1), corInterna);
+        Triangulos.push_back(Vertice(cx, cy, corInterna));
+        Triangulos.push_back(p0);
+        Triangulos.push_back(p1);
+
+        Linhas.push_back(Vertice(p0.x, p0.y, corBorda));
+        Linhas.push_back(Vertice(p1.x, p1.y, corBorda));
+    }
+}
+
+void DesenhaVerticesColoridos(GLenum modo, const vector<VerticeColorido> &V)
+{
+    if (V.empty())
+        return;
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, sizeof(VerticeColorido), &V[0].x);
+    glColorPointer(3, GL_FLOAT, sizeof(VerticeColorido), &V[0].r);
+    glDrawArrays(modo, 0, (GLsizei)V.size());
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+void ModeloCompilado::compila()
+{
+    if (Lista == 0)
+        Lista = glGenLists(1);
+    // Com a display list gravada, os vertices passam a morar no driver
+    glNewList(Lista, GL_COMPILE);
+        DesenhaVerticesColoridos(GL_TRIANGLES, Triangulos);
+        DesenhaVerticesColoridos(GL_LINES, Linhas);
+    glEndList();
+}
+
+LoteDeInstancias::LoteDeInstancias()
+{
+    Modelo = NULL;
+}
+
+static void ExpandeInstancias(const vector<VerticeColorido> &Modelo,
+                              const vector<InstanciaDoLote> &Instancias,
+                              vector<VerticeColorido> &Saida)
+{
+    size_t nv = Modelo.size();
+    Saida.resize(nv * Instancias.size());
+    VerticeColorido *out = Saida.empty() ? NULL : &Saida[0];
+    for (size_t k = 0; k < Instancias.size(); k++)
+    {
+        const float *M = Instancias[k].M;
+        const float *T = Instancias[k].Tinta;
+        for (size_t v = 0; v < nv; v++, out++)
+        {
+            const VerticeColorido &p = Modelo[v];
+            out->x = M[0] * p.x + M[1] * p.y + M[2];
+            out->y = M[3] * p.x + M[4] * p.y + M[5];
+            out->r = p.r * T[0];
+            out->g = p.g * T[1];
+            out->b = p.b * T[2];
+        }
+    }
+}
+
+int LoteDeInstancias::desenha()
+{
+    if (Modelo == NULL || Instancias.empty())
+        return 0;
+    int chamadas = 0;
+    ExpandeInstancias(Modelo->Triangulos, Instancias, TriangulosNoMundo);
+    ExpandeInstancias(Modelo->Linhas, Instancias, LinhasNoMundo);
+    if (!TriangulosNoMundo.empty())
+    {
+        DesenhaVerticesColoridos(GL_TRIANGLES, TriangulosNoMundo);
+        chamadas++;
+    }
+    if (!LinhasNoMundo.empty())
+    {
+        DesenhaVerticesColoridos(GL_LINES, LinhasNoMundo);
+        chamadas++;
+    }
+    return chamadas;
+}
+
+void ModeloCompilado::desenha() const
+{
+    if (Lista != 0)
+        glCallList(Lista);
+    else
+    {
+        DesenhaVerticesColoridos(GL_TRIANGLES, Triangulos);
+        DesenhaVerticesColoridos(GL_LINES, Linhas);
+    }
+}
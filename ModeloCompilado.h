@@ -0,0 +1,97 @@
+//
+//  ModeloCompilado.h
+//  OpenGLTest
+//
+//  Geometria de um modelo pronta para desenho: as celulas de um
+//  ModeloMatricial (ou um disco, no caso do projetil) viram listas de
+//  vertices coloridos, montadas uma unica vez na carga dos modelos e
+//  gravadas numa display list. Cada instancia eh desenhada com um
+//  glCallList, em vez de um glBegin/glEnd por celula.
+//
+
+#ifndef ModeloCompilado_hpp
+#define ModeloCompilado_hpp
+
+#include <vector>
+using namespace std;
+
+#ifdef WIN32
+#include <windows.h>
+#include <glut.h>
+#endif
+
+#ifdef __APPLE__
+#include <GLUT/glut.h>
+#endif
+
+#ifdef __linux__
+#include <GL/glut.h>
+#endif
+
+#include "ModeloMatricial.h"
+
+struct VerticeColorido
+{
+    float x, y;
+    float r, g, b;
+};
+
+class ModeloCompilado
+{
+    GLuint Lista; // 0 enquanto nao compilado
+public:
+    vector<VerticeColorido> Triangulos; // preenchimento (GL_TRIANGLES)
+    vector<VerticeColorido> Linhas;     // bordas (GL_LINES)
+
+    ModeloCompilado();
+
+    void limpa(); // apaga os vertices e a display list
+
+    // Celula unitaria da coluna j, linha i (contada de baixo para cima)
+    void adicionaCelula(int i, int j, const float corInterna[3], const float corBorda[3]);
+
+    // Disco de raio r com centro (cx,cy), aproximado por n lados
+    void adicionaDisco(float cx, float cy, float r, int n, const float corInterna[3], const float corBorda[3]);
+
+    // Grava os vertices numa display list (requer contexto OpenGL)
+    void compila();
+
+    // Desenha com a transformacao corrente
+    void desenha() const;
+};
+
+// Desenha listas de vertices coloridos com vertex arrays
+void DesenhaVerticesColoridos(GLenum modo, const vector<VerticeColorido> &V);
+
+// Dados de uma instancia num lote: transformacao afim
+//   x' = M[0]*x + M[1]*y + M[2]
+//   y' = M[3]*x + M[4]*y + M[5]
+// e uma tinta que multiplica as cores do modelo
+struct InstanciaDoLote
+{
+    float M[6];
+    float Tinta[3];
+};
+
+// Todas as instancias de um mesmo modelo num frame. O fixed-function
+// do OpenGL nao tem atributos por instancia, entao o lote expande as
+// instancias na CPU para um unico vetor de vertices ja no mundo, e
+// desenha o modelo inteiro com um glDrawArrays para o preenchimento e
+// outro para as bordas, qualquer que seja o numero de instancias.
+class LoteDeInstancias
+{
+    vector<VerticeColorido> TriangulosNoMundo;
+    vector<VerticeColorido> LinhasNoMundo;
+public:
+    const ModeloCompilado *Modelo;
+    vector<InstanciaDoLote> Instancias;
+
+    LoteDeInstancias();
+    void limpa() { Instancias.clear(); }
+    void adiciona(const InstanciaDoLote &I) { Instancias.push_back(I); }
+
+    // Retorna o numero de chamadas de desenho feitas (0 a 2)
+    int desenha();
+};
+
+#endif /* ModeloCompilado_hpp */
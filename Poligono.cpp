@@ -7,18 +7,23 @@
 //
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 using namespace std;
 
 #include "Poligono.h"
+#include "LeitorDePoligonos.h"
+#include "Triangulacao.h"
 #include <GL/gl.h>
 
 Poligono::Poligono()
 {
+    invalidaPropriedades();
+    invalidaTriangulacao();
 }
 
 void Poligono::insereVertice(Ponto p)
 {
-    Vertices.push_back(p);
+    insereVertice(p, static_cast<int>(Vertices.size()));
 }
 
 void Poligono::insereVertice(Ponto P, int pos)
@@ -28,7 +33,23 @@ void Poligono::insereVertice(Ponto P, int pos)
     if (static_cast<size_t>(pos) > Vertices.size())
         pos = static_cast<int>(Vertices.size());
 
+    // O novo vertice entra na aresta (anterior, proximo)
+    if (SomasValidas && !Vertices.empty())
+    {
+        const size_t n = Vertices.size();
+        const Ponto Ant = Vertices[(pos + n - 1) % n];
+        const Ponto Prox = Vertices[pos % n];
+        somaAresta(Ant, Prox, -1);
+        somaAresta(Ant, P, 1);
+        somaAresta(P, Prox, 1);
+    }
+    if (LimitesValidos)
+        expandeLimites(P);
+    ConvexidadeValida = false;
+
     Vertices.insert(Vertices.begin() + pos, P);
+    Buffer.marcaSujo(pos, Vertices.size()); // os seguintes andaram uma posicao
+    invalidaTriangulacao();
 }
 
 Ponto Poligono::getVertice(int i)
@@ -36,28 +57,61 @@ Ponto Poligono::getVertice(int i)
     return Vertices[static_cast<size_t>(i)];
 }
 
+// Um unico glDrawArrays sobre o buffer de vertices
+void Poligono::desenhaComBuffer(GLenum modo)
+{
+    if (Vertices.empty())
+        return;
+    Buffer.ativa(Vertices);
+    glDrawArrays(modo, 0, static_cast<GLsizei>(Vertices.size()));
+    Buffer.desativa();
+}
+
+void Poligono::invalidaTriangulacao()
+{
+    TriangulacaoValida = TriangulacaoFalhou = false;
+}
+
+bool Poligono::obtemTriangulos(const vector<unsigned> *&Indices)
+{
+    if (!TriangulacaoValida)
+    {
+        TriangulacaoFalhou = !TriangulaPoligono(Vertices, Triangulos);
+        TriangulacaoValida = true;
+        BufferTriangulos.marcaSujo();
+    }
+    Indices = &Triangulos;
+    return !TriangulacaoFalhou;
+}
+
+// Preenche com os triangulos em cache (um unico glDrawElements). Se o
+// poligono nao pode ser triangulado (arestas que se cruzam), usa
+// GL_POLYGON, que so fica certo para poligonos convexos.
 void Poligono::pintaPoligono()
 {
-    glBegin(GL_POLYGON);
-    for (size_t i = 0; i < Vertices.size(); ++i)
-        glVertex3f(Vertices[i].x, Vertices[i].y, Vertices[i].z);
-    glEnd();
+    const vector<unsigned> *Indices;
+    if (Vertices.empty())
+        return;
+    if (!obtemTriangulos(Indices) || Indices->empty())
+    {
+        desenhaComBuffer(GL_POLYGON);
+        return;
+    }
+    Buffer.ativa(Vertices);
+    const void *Deslocamento = BufferTriangulos.ativa(*Indices);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(Indices->size()), GL_UNSIGNED_INT, Deslocamento);
+    BufferTriangulos.desativa();
+    Buffer.desativa();
 }
 
 void Poligono::desenhaPoligono()
 {
-    glBegin(GL_LINE_LOOP);
-    for (size_t i = 0; i < Vertices.size(); ++i)
-        glVertex3f(Vertices[i].x, Vertices[i].y, Vertices[i].z);
-    glEnd();
+    desenhaComBuffer(GL_LINE_LOOP);
 }
 
 void Poligono::desenhaVertices()
 {
-    glBegin(GL_POINTS);
-    for (size_t i = 0; i < Vertices.size(); ++i)
-        glVertex3f(Vertices[i].x, Vertices[i].y, Vertices[i].z);
-    glEnd();
+    desenhaComBuffer(GL_POINTS);
 }
 
 void Poligono::imprime()
@@ -66,26 +120,252 @@ void Poligono::imprime()
         Vertices[i].imprime();
 }
 
+void Poligono::imprimeVertices()
+{
+    for (size_t i = 0; i < Vertices.size(); ++i)
+        Vertices[i].imprime("", "\n");
+}
+
 unsigned long Poligono::getNVertices()
 {
     return static_cast<unsigned long>(Vertices.size());
 }
 
-void Poligono::obtemLimites(Ponto &Min, Ponto &Max)
+// **********************************************************************
+// Propriedades derivadas
+// **********************************************************************
+void Poligono::invalidaPropriedades()
+{
+    LimitesValidos = SomasValidas = ConvexidadeValida = false;
+}
+
+// Soma (sinal = 1) ou retira (sinal = -1) a contribuicao da aresta A-B
+void Poligono::somaAresta(const Ponto &A, const Ponto &B, double sinal)
+{
+    const double cruz = (double)A.x * B.y - (double)B.x * A.y;
+    const double dx = (double)B.x - A.x, dy = (double)B.y - A.y;
+    Soma2Area += sinal * cruz;
+    SomaCx += sinal * ((double)A.x + B.x) * cruz;
+    SomaCy += sinal * ((double)A.y + B.y) * cruz;
+    Perimetro += sinal * sqrt(dx * dx + dy * dy);
+}
+
+void Poligono::atualizaSomas()
+{
+    Soma2Area = SomaCx = SomaCy = Perimetro = 0;
+    const size_t n = Vertices.size();
+    for (size_t i = 0; i < n; ++i)
+        somaAresta(Vertices[i], Vertices[(i + 1) % n], 1);
+    SomasValidas = true;
+}
+
+void Poligono::expandeLimites(const Ponto &P)
+{
+    if (Vertices.empty())
+        Min = Max = P;
+    else
+    {
+        Min = ObtemMinimo(P, Min);
+        Max = ObtemMaximo(P, Max);
+    }
+}
+
+void Poligono::atualizaLimites()
 {
-    Max = Min = Vertices[0];
+    if (Vertices.empty())
+        Min = Max = Ponto(0, 0, 0);
+    else
+        Max = Min = Vertices[0];
 
     for (size_t i = 0; i < Vertices.size(); ++i)
     {
         Min = ObtemMinimo(Vertices[i], Min);
         Max = ObtemMaximo(Vertices[i], Max);
     }
+    LimitesValidos = true;
+}
+
+void Poligono::obtemLimites(Ponto &Min, Ponto &Max)
+{
+    if (!LimitesValidos)
+        atualizaLimites();
+    Min = this->Min;
+    Max = this->Max;
+}
+
+double Poligono::getAreaComSinal()
+{
+    if (!SomasValidas)
+        atualizaSomas();
+    return Soma2Area / 2;
+}
+
+Ponto Poligono::getCentroide()
+{
+    if (!SomasValidas)
+        atualizaSomas();
+    const size_t n = Vertices.size();
+    if (n == 0)
+        return Ponto(0, 0, 0);
+    // Sem area (pontos colineares), usa a media dos vertices
+    if (fabs(Soma2Area) <= 1e-12 * max(1.0, Perimetro * Perimetro))
+    {
+        double x = 0, y = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            x += Vertices[i].x;
+            y += Vertices[i].y;
+        }
+        return Ponto(x / n, y / n);
+    }
+    return Ponto(SomaCx / (3 * Soma2Area), SomaCy / (3 * Soma2Area));
+}
+
+double Poligono::getPerimetro()
+{
+    if (!SomasValidas)
+        atualizaSomas();
+    return Perimetro;
+}
+
+OrientacaoDoPoligono Poligono::getOrientacao()
+{
+    double a = getAreaComSinal();
+    if (a > 0)
+        return POLIGONO_ANTI_HORARIO;
+    if (a < 0)
+        return POLIGONO_HORARIO;
+    return POLIGONO_DEGENERADO;
+}
+
+// Convexo: todas as curvas para o mesmo lado (ignorando vertices
+// colineares) e uma unica volta, ou seja, a direcao x das arestas
+// troca de sinal no maximo duas vezes
+void Poligono::atualizaConvexidade()
+{
+    const size_t n = Vertices.size();
+    ConvexidadeValida = true;
+    Convexo = true;
+    if (n < 3)
+        return;
+    int sinal = 0, trocasX = 0, sinalXAnt = 0;
+    for (size_t i = 0; i < n && Convexo; ++i)
+    {
+        const Ponto &A = Vertices[i];
+        const Ponto &B = Vertices[(i + 1) % n];
+        const Ponto &C = Vertices[(i + 2) % n];
+        double cruz = ((double)B.x - A.x) * ((double)C.y - B.y) - ((double)B.y - A.y) * ((double)C.x - B.x);
+        int s = (cruz > 0) - (cruz < 0);
+        if (s != 0)
+        {
+            if (sinal != 0 && s != sinal)
+                Convexo = false;
+            sinal = s;
+        }
+        int sx = (B.x > A.x) - (B.x < A.x);
+        if (sx != 0)
+        {
+            if (sinalXAnt != 0 && sx != sinalXAnt)
+                trocasX++;
+            sinalXAnt = sx;
+        }
+    }
+    // A troca entre a ultima e a primeira aresta nao eh contada; basta,
+    // pois com mais de duas trocas no ciclo sobram mais de duas aqui
+    if (trocasX > 2)
+        Convexo = false;
+}
+
+bool Poligono::ehConvexo()
+{
+    if (!ConvexidadeValida)
+        atualizaConvexidade();
+    return Convexo;
+}
+
+void Poligono::reservaVertices(unsigned long n)
+{
+    Vertices.reserve(n);
+}
+
+// Acrescenta um vetor inteiro de uma vez. Num poligono vazio o vetor
+// eh trocado, sem copiar.
+void Poligono::insereVertices(vector<Ponto> &Novos)
+{
+    invalidaPropriedades();
+    invalidaTriangulacao();
+    Buffer.marcaTudoSujo();
+    if (Vertices.empty())
+        Vertices.swap(Novos);
+    else
+        Vertices.insert(Vertices.end(), Novos.begin(), Novos.end());
+    Novos.clear();
+}
+
+const vector<Ponto> &Poligono::getVertices() const
+{
+    return Vertices;
+}
+
+void Poligono::limpa()
+{
+    Vertices.clear();
+    invalidaPropriedades();
+    invalidaTriangulacao();
+    Buffer.marcaTudoSujo();
 }
 
 // **********************************************************************
-//
+// Le o arquivo mapeado na memoria (ver LeitorDePoligonos.h).
+// Se ja existe um cache binario em dia, usa o cache; senao converte o
+// texto e grava o cache para as proximas execucoes.
+// Se alguma linha estiver mal formada, informa a linha e fica com os
+// vertices lidos ate ali (nesse caso o cache nao eh gravado).
 // **********************************************************************
 void Poligono::LePoligono(const char *nome)
+{
+    cout << "Lendo arquivo " << nome << "...";
+    vector<Ponto> lidos;
+    Ponto MinLido, MaxLido;
+    bool doCache = LeCacheDoPoligono(nome, lidos, MinLido, MaxLido);
+    if (!doCache)
+    {
+        string erro;
+        ResultadoDaLeitura r = LeVerticesDoArquivo(nome, lidos, erro);
+        if (r == LEITURA_SEM_ARQUIVO)
+        {
+            cout << erro << endl;
+            exit(0);
+        }
+        if (r == LEITURA_MAL_FORMADO)
+            cout << endl << erro << endl;
+        else if (!GravaCacheDoPoligono(nome, lidos))
+            cout << "(cache nao gravado) ";
+    }
+    else
+        cout << "(cache) ";
+    invalidaPropriedades();
+    invalidaTriangulacao();
+    Buffer.marcaTudoSujo();
+    if (Vertices.empty())
+    {
+        Vertices.swap(lidos);
+        if (doCache)
+        {
+            Min = MinLido; // limites gravados no cabecalho do cache
+            Max = MaxLido;
+            LimitesValidos = true;
+        }
+    }
+    else
+        Vertices.insert(Vertices.end(), lidos.begin(), lidos.end());
+    cout << "Poligono lido com sucesso!" << endl;
+}
+
+// **********************************************************************
+// Versao original, com ifstream. Mantida para comparacao (make bench).
+// **********************************************************************
+void Poligono::LePoligonoStream(const char *nome)
 {
     ifstream input;            // ofstream arq;
     input.open(nome, ios::in); // arq.open(nome, ios::out);
@@ -135,5 +415,30 @@ void Poligono::desenhaAresta(int n)
 
 void Poligono::alteraVertice(int i, Ponto P)
 {
-    Vertices[static_cast<size_t>(i)] = P;
+    const size_t idx = static_cast<size_t>(i);
+    const size_t n = Vertices.size();
+    const Ponto Antigo = Vertices[idx];
+    if (SomasValidas)
+    {
+        const Ponto Ant = Vertices[(idx + n - 1) % n];
+        const Ponto Prox = Vertices[(idx + 1) % n];
+        somaAresta(Ant, Antigo, -1);
+        somaAresta(Antigo, Prox, -1);
+        // Com um so vertice, Ant e Prox sao o proprio vertice
+        somaAresta(n == 1 ? P : Ant, P, 1);
+        somaAresta(P, n == 1 ? P : Prox, 1);
+    }
+    // Se o vertice antigo definia algum limite, so uma varredura diz
+    // qual eh o novo limite
+    if (LimitesValidos)
+    {
+        if (Antigo.x > Min.x && Antigo.x < Max.x && Antigo.y > Min.y && Antigo.y < Max.y)
+            expandeLimites(P);
+        else
+            LimitesValidos = false;
+    }
+    ConvexidadeValida = false;
+    Vertices[idx] = P;
+    Buffer.marcaSujo(idx, idx + 1);
+    invalidaTriangulacao();
 }
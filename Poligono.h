@@ -27,12 +27,47 @@ using namespace std;
 #endif
 
 #include "Ponto.h"
+#include "BufferDeVertices.h"
 #include <vector>
 
+enum OrientacaoDoPoligono
+{
+    POLIGONO_ANTI_HORARIO,
+    POLIGONO_HORARIO,
+    POLIGONO_DEGENERADO // area zero
+};
+
 class Poligono
 {
     vector <Ponto> Vertices;
     Ponto Min, Max;
+
+    // Propriedades derivadas, guardadas em cache. insereVertice e
+    // alteraVertice atualizam as somas e os limites em O(1) sempre que
+    // possivel; as demais alteracoes so invalidam e o calculo eh feito
+    // na proxima consulta.
+    bool LimitesValidos, SomasValidas, ConvexidadeValida;
+    double Soma2Area;       // soma de xi*yj - xj*yi (2 * area com sinal)
+    double SomaCx, SomaCy;  // somas do centroide
+    double Perimetro;
+    bool Convexo;
+
+    // Copia dos vertices na placa de video, reenviada por trechos
+    BufferDeVertices Buffer;
+    void desenhaComBuffer(GLenum modo);
+
+    // Triangulacao usada no preenchimento; refeita depois de qualquer
+    // alteracao nos vertices
+    vector<unsigned> Triangulos;
+    BufferDeIndices BufferTriangulos;
+    bool TriangulacaoValida, TriangulacaoFalhou;
+    void invalidaTriangulacao();
+
+    void invalidaPropriedades();
+    void somaAresta(const Ponto &A, const Ponto &B, double sinal);
+    void atualizaSomas();
+    void atualizaConvexidade();
+    void expandeLimites(const Ponto &P);
 public:
     Poligono();
     Ponto getVertice(int);
@@ -45,11 +80,26 @@ public:
     void imprime();
     void atualizaLimites();
     void obtemLimites(Ponto &Min, Ponto &Max);
-    void LePoligono(const char *nome);
+    void LePoligono(const char *nome);       // leitura rapida (mmap)
+    void LePoligonoStream(const char *nome); // leitura antiga, com ifstream
+    void reservaVertices(unsigned long n);
+    void insereVertices(vector<Ponto> &Novos); // no fim; esvazia Novos
+    const vector<Ponto> &getVertices() const;
+    void limpa();
     void desenhaAresta(int n);
     void getAresta(int i, Ponto &P1, Ponto &P2);
     void alteraVertice(int i, Ponto P);
     void imprimeVertices();
+
+    double getAreaComSinal();   // > 0 se anti-horario
+    Ponto getCentroide();
+    double getPerimetro();      // inclui a aresta que fecha o poligono
+    OrientacaoDoPoligono getOrientacao();
+    bool ehConvexo();
+
+    // Indices (triplas) dos triangulos que cobrem o poligono. Retorna
+    // false se o poligono nao eh simples e nao pode ser triangulado.
+    bool obtemTriangulos(const vector<unsigned> *&Indices);
 };
 
 #endif 
@@ -6,6 +6,8 @@
 //  Copyright © 2020 Márcio Sarroglia Pinho. All rights reserved.
 //
 
+#include <cfloat>
+
 #include "Ponto.h"
 Ponto::Ponto ()
 {
@@ -215,6 +217,71 @@ bool HaInterseccao(Ponto k, Ponto l, Ponto m, Ponto n)
 
 }
 // **********************************************************************
+//  Sinal exato de uma soma de doubles: a soma eh mantida como uma
+//  expansao (componentes que nao se sobrepoem, em ordem crescente de
+//  magnitude), somando cada termo com Two-Sum, sem arredondamento.
+//  O sinal eh o do maior componente nao nulo.
+// **********************************************************************
+static int SinalDaSoma(const double *termos, int n)
+{
+    double Expansao[8];
+    int nComp = 0;
+    for (int k = 0; k < n; k++)
+    {
+        double q = termos[k];
+        for (int c = 0; c < nComp; c++)
+        {
+            double soma = q + Expansao[c];
+            double bv = soma - q;
+            double erro = (q - (soma - bv)) + (Expansao[c] - bv);
+            Expansao[c] = erro;
+            q = soma;
+        }
+        Expansao[nComp++] = q;
+    }
+    for (int c = nComp - 1; c >= 0; c--)
+        if (Expansao[c] != 0)
+            return Expansao[c] > 0 ? 1 : -1;
+    return 0;
+}
+// **********************************************************************
+//  Sinal de (B-A) x (D-C). As coordenadas sao float, entao cada produto
+//  de duas delas eh exato em double; o produto vetorial expandido eh
+//  uma soma de 8 desses produtos. A soma comum erra no maximo
+//  7*DBL_EPSILON*(soma dos modulos); so quando ela fica abaixo disso
+//  eh que se faz a soma exata.
+// **********************************************************************
+static int SinalDoProdVetorial(Ponto A, Ponto B, Ponto C, Ponto D)
+{
+    double t[8] = {
+        (double)B.x * D.y, -(double)B.x * C.y, -(double)A.x * D.y, (double)A.x * C.y,
+        -(double)B.y * D.x, (double)B.y * C.x, (double)A.y * D.x, -(double)A.y * C.x};
+    double soma = 0, modulos = 0;
+    for (int k = 0; k < 8; k++)
+    {
+        soma += t[k];
+        modulos += fabs(t[k]);
+    }
+    if (fabs(soma) > 8 * DBL_EPSILON * modulos)
+        return soma > 0 ? 1 : -1;
+    return SinalDaSoma(t, 8);
+}
+// **********************************************************************
+//
+// **********************************************************************
+bool HaInterseccaoExata(Ponto k, Ponto l, Ponto m, Ponto n)
+{
+    ContadorInt = ContadorInt + 1;
+    if (SinalDoProdVetorial(k, l, m, n) == 0)
+        return false; // paralelas, como em intersec2d
+    // m e n nao podem estar do mesmo lado de kl, nem k e l do mesmo lado de mn
+    if (SinalDoProdVetorial(k, l, k, m) * SinalDoProdVetorial(k, l, k, n) > 0)
+        return false;
+    if (SinalDoProdVetorial(m, n, m, k) * SinalDoProdVetorial(m, n, m, l) > 0)
+        return false;
+    return true;
+}
+// **********************************************************************
 //
 // **********************************************************************
 void resetContadorInt()
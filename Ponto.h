@@ -47,6 +47,10 @@ double ProdEscalar(Ponto v1, Ponto v2);
 void ProdVetorial (Ponto v1, Ponto v2, Ponto &vresult);
 int intersec2d(Ponto k, Ponto l, Ponto m, Ponto n, double &s, double &t);
 bool HaInterseccao(Ponto k, Ponto l, Ponto m, Ponto n);
+// Mesmo criterio de HaInterseccao (retas paralelas nao se intersectam,
+// toque nas extremidades conta), mas decidido com produtos vetoriais
+// exatos: nao erra com linhas quase paralelas
+bool HaInterseccaoExata(Ponto k, Ponto l, Ponto m, Ponto n);
 
 long int getContadorInt();
 void resetContadorInt();
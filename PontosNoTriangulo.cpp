@@ -15,6 +15,7 @@
 // Selecione a pasta onde voce descompactou o ZIP que continha este arquivo.
 
 #include <iostream>
+#include <cstdlib>
 #include <cmath>
 #include <ctime>
 #include <fstream>
@@ -38,6 +39,12 @@ using namespace std;
 
 #include "Ponto.h"
 #include "Poligono.h"
+#include "FechoConvexo.h"
+#include "TrianguloDeConsulta.h"
+#include "QuadTreeDePontos.h"
+#include "KdTreeDePontos.h"
+#include "CampoDeVisaoIncremental.h"
+#include "GeradorDePontos.h"
 
 #include "Temporizador.h"
 Temporizador T;
@@ -45,6 +52,7 @@ double AccumDeltaT=0;
 
 // Variaveis que controlam o triangulo do campo de visao
 Poligono PontosDoCenario, CampoDeVisao, TrianguloBase;
+Poligono ConvexHull; // fecho convexo dos pontos do cenario
 float AnguloDoCampoDeVisao=0.0;
 
 // Limites logicos da area de desenho
@@ -52,28 +60,52 @@ Ponto Min, Max, Tamanho, Meio;
 Ponto PosicaoDoCampoDeVisao, PontoClicado;
 
 bool desenhaEixos = true;
+bool desenhaFecho = false;
+bool desenhaQuadTree = false;
 bool FoiClicado = false;
 
+// Indice dos pontos do cenario e resultado da consulta do campo de visao
+QuadTreeDePontos QuadTree(16);
+vector<int> PontosDentro;
+ContadoresDaConsulta ContadoresQuadTree, ContadoresForcaBruta;
+
+// Consulta incremental ('i'): as setas so examinam os pontos perto das
+// arestas dos dois triangulos e informam os que entraram e sairam
+CampoDeVisaoIncremental CampoIncremental;
+bool ConsultaIncremental = false;
+
+// Varredura ('v'): com ate LIMITE_DA_VARREDURA pontos, a consulta
+// completa testa todos os pontos com FiltraPontosNoTriangulo em vez de
+// descer a quadtree. X e Y sao copias das coordenadas dos pontos.
+bool UsaVarredura = false;
+vector<float> XDosPontos, YDosPontos;
+
+// Pontos do cenario: quantidade, distribuicao e semente vem da linha
+// de comando ("PontosNoTriangulo 1000000 agrupada 7")
+GeradorDePontos Gerador(1);
+long QtdDePontos = 1000;
+
+// Os K pontos mais proximos do vertice do campo de visao
+KdTreeDePontos KdTree(8);
+int KVizinhos = 8;
+vector<int> MaisProximos;
+
 
 
 // **********************************************************************
 // GeraPontos(int qtd)
-//      Mtodo que gera pontos aleatrios no intervalo [Min..Max]
+//      Gera pontos aleatorios no intervalo [Min..Max] com o Gerador
+//      (sempre os mesmos para a mesma semente), em paralelo, num vetor
+//      alocado de uma vez.
 // **********************************************************************
 void GeraPontos(unsigned long int qtd, Ponto Min, Ponto Max)
 {
-    time_t t;
-    Ponto Escala;
-    Escala = (Max - Min) * (1.0/1000.0);
-    srand((unsigned) time(&t));
-    for (int i = 0;i<qtd; i++)
-    {
-        float x = rand() % 1000;
-        float y = rand() % 1000;
-        x = x * Escala.x + Min.x;
-        y = y * Escala.y + Min.y;
-        PontosDoCenario.insereVertice(Ponto(x,y));
-    }
+    Temporizador Tempo;
+    vector<Ponto> Novos;
+    Gerador.Gera(Novos, qtd, Min, Max);
+    PontosDoCenario.insereVertices(Novos);
+    cout << qtd << " pontos (" << NomeDaDistribuicao(Gerador.getDistribuicao()) << ", semente "
+         << Gerador.getSemente() << ") gerados em " << Tempo.getDeltaT()*1000 << " ms" << endl;
 }
 
 // **********************************************************************
@@ -100,6 +132,87 @@ void CriaTrianguloDoCampoDeVisao()
     
 }
 // **********************************************************************
+// void ConsultaCampoDeVisao(bool moveu)
+//  Procura os pontos do cenario dentro do campo de visao com a
+//  quadtree (ou com a varredura, se ligada e a nuvem for pequena) e
+//  mostra o trabalho feito ao lado do da forca bruta.
+//  Se o campo de visao so moveu um passo e a consulta incremental
+//  esta ligada, so atualiza o conjunto anterior com os pontos que
+//  entraram e sairam (sem a forca bruta, que eh O(n)).
+// **********************************************************************
+void ConsultaCampoDeVisao(bool moveu = false)
+{
+    TrianguloDeConsulta T(CampoDeVisao.getVertice(0), CampoDeVisao.getVertice(1),
+                          CampoDeVisao.getVertice(2));
+
+    ContadoresQuadTree.zera();
+    if (moveu && ConsultaIncremental)
+    {
+        CampoIncremental.move(QuadTree, T, &ContadoresQuadTree);
+        cout << "Incremental: " << CampoIncremental.getDentro().size() << " pontos dentro, "
+             << CampoIncremental.getEntraram().size() << " entraram, "
+             << CampoIncremental.getSairam().size() << " sairam, "
+             << ContadoresQuadTree.NosVisitados << " nos visitados, "
+             << ContadoresQuadTree.PontosTestados << " pontos testados" << endl;
+    }
+    else if (UsaVarredura && (long)XDosPontos.size() <= LIMITE_DA_VARREDURA)
+    {
+        PontosDentro.clear();
+        AcrescentaPontosNoTriangulo(XDosPontos.data(), YDosPontos.data(), nullptr,
+                                    (int)XDosPontos.size(), T, PontosDentro);
+        cout << "Varredura: " << PontosDentro.size() << " pontos dentro, "
+             << XDosPontos.size() << " pontos testados" << endl;
+        if (ConsultaIncremental)
+            CampoIncremental.reinicia(QuadTree, T);
+    }
+    else
+    {
+        QuadTree.PontosNoTriangulo(T, PontosDentro, &ContadoresQuadTree);
+        cout << "Quadtree: " << PontosDentro.size() << " pontos dentro, "
+             << ContadoresQuadTree.NosVisitados << " nos visitados, "
+             << ContadoresQuadTree.PontosTestados << " pontos testados, "
+             << ContadoresQuadTree.PontosAceitosEmBloco << " aceitos em bloco" << endl;
+        if (ConsultaIncremental)
+            CampoIncremental.reinicia(QuadTree, T);
+    }
+
+    ContadoresDaConsulta ContadoresKd;
+    KdTree.MaisProximos(PosicaoDoCampoDeVisao, KVizinhos, MaisProximos, &ContadoresKd);
+    cout << "Kd-tree: " << MaisProximos.size() << " mais proximos do vertice, "
+         << ContadoresKd.NosVisitados << " nos visitados, "
+         << ContadoresKd.PontosTestados << " pontos testados" << endl;
+    if (moveu && ConsultaIncremental)
+        return;
+
+    static vector<int> DentroForcaBruta;
+    ContadoresForcaBruta.zera();
+    PontosNoTrianguloForcaBruta(PontosDoCenario.getVertices(), T, DentroForcaBruta, &ContadoresForcaBruta);
+
+    cout << "Forca bruta: " << DentroForcaBruta.size() << " pontos dentro, "
+         << ContadoresForcaBruta.PontosTestados << " pontos testados" << endl;
+}
+// **********************************************************************
+// void ConstroiQuadTree()
+// **********************************************************************
+void ConstroiQuadTree()
+{
+    Temporizador Tempo;
+    const vector<Ponto> &P = PontosDoCenario.getVertices();
+    XDosPontos.resize(P.size());
+    YDosPontos.resize(P.size());
+    for (size_t i = 0; i < P.size(); i++)
+    {
+        XDosPontos[i] = P[i].x;
+        YDosPontos[i] = P[i].y;
+    }
+    QuadTree.Constroi(P);
+    cout << "Quadtree com folhas de ate " << QuadTree.getCapacidadeDaFolha() << " pontos: "
+         << QuadTree.getNroDeNos() << " nos, profundidade " << QuadTree.getProfundidade()
+         << ", construida em " << Tempo.getDeltaT()*1000 << " ms" << endl;
+    KdTree.Constroi(PontosDoCenario.getVertices());
+    cout << "Kd-tree construida em " << Tempo.getDeltaT()*1000 << " ms" << endl;
+}
+// **********************************************************************
 // void PosicionaTrianguloDoCampoDeVisao()
 //  Posiciona o campo de viso na posicao PosicaoDoCampoDeVisao,
 //  com a orientacao "AnguloDoCampoDeVisao".
@@ -141,9 +254,10 @@ void init()
     // da janela.
     
     // PontosDoCenario.LePoligono("PontosDenteDeSerra.txt");
-    GeraPontos(1000, Ponto(0,0), Ponto(500,500));
+    GeraPontos(QtdDePontos, Ponto(0,0), Ponto(500,500));
     
     PontosDoCenario.obtemLimites(Min,Max);
+    GeraFechoConvexo(PontosDoCenario, ConvexHull);
     Min.x--;Min.y--;
     Max.x++;Max.y++;
     
@@ -157,6 +271,9 @@ void init()
     // Cria o triangulo que representa o campo de visao
     CriaTrianguloDoCampoDeVisao();
     PosicionaTrianguloDoCampoDeVisao();
+
+    ConstroiQuadTree();
+    ConsultaCampoDeVisao();
 }
 
 double nFrames=0;
@@ -253,10 +370,71 @@ void display( void )
         DesenhaEixos();
     }
 
+    if (desenhaQuadTree)
+    {
+        static vector<AABB> Folhas;
+        QuadTree.obtemFolhas(Folhas);
+        glLineWidth(1);
+        glColor3f(0.5,0.5,1); // R, G, B  [0..1]
+        for (const AABB &B : Folhas)
+        {
+            glBegin(GL_LINE_LOOP);
+                glVertex2f(B.minX, B.minY);
+                glVertex2f(B.maxX, B.minY);
+                glVertex2f(B.maxX, B.maxY);
+                glVertex2f(B.minX, B.maxY);
+            glEnd();
+        }
+    }
+
     //glPointSize(5);
     glColor3f(1,1,0); // R, G, B  [0..1]
     PontosDoCenario.desenhaVertices();
+
+    // Pontos dentro do campo de visao
+    glPointSize(3);
+    glColor3f(0,1,0); // R, G, B  [0..1]
+    glBegin(GL_POINTS);
+    const vector<int> &Dentro = ConsultaIncremental ? CampoIncremental.getDentro() : PontosDentro;
+    for (int i : Dentro)
+    {
+        Ponto P = PontosDoCenario.getVertice(i);
+        glVertex2f(P.x, P.y);
+    }
+    glEnd();
+
+    // Pontos que sairam do campo de visao no ultimo passo
+    if (ConsultaIncremental)
+    {
+        glColor3f(1,0,0); // R, G, B  [0..1]
+        glBegin(GL_POINTS);
+        for (int i : CampoIncremental.getSairam())
+        {
+            Ponto P = PontosDoCenario.getVertice(i);
+            glVertex2f(P.x, P.y);
+        }
+        glEnd();
+    }
+
+    // Mais proximos do vertice do campo de visao
+    glPointSize(5);
+    glColor3f(1,0,1); // R, G, B  [0..1]
+    glBegin(GL_POINTS);
+    for (int i : MaisProximos)
+    {
+        Ponto P = PontosDoCenario.getVertice(i);
+        glVertex2f(P.x, P.y);
+    }
+    glEnd();
+    glPointSize(1);
     
+    if (desenhaFecho)
+    {
+        glLineWidth(1);
+        glColor3f(0,1,1); // R, G, B  [0..1]
+        ConvexHull.desenhaPoligono();
+    }
+
     glLineWidth(3);
     glColor3f(1,0,0); // R, G, B  [0..1]
     CampoDeVisao.desenhaPoligono();
@@ -311,6 +489,46 @@ void keyboard ( unsigned char key, int x, int y )
         case ' ':
             desenhaEixos = !desenhaEixos;
         break;
+        case 'h':
+            desenhaFecho = !desenhaFecho;
+            break;
+        case 'q':
+            desenhaQuadTree = !desenhaQuadTree;
+            break;
+        case 'd':
+            // Proxima distribuicao, com os mesmos limites
+            Gerador.setDistribuicao((DistribuicaoDosPontos)((Gerador.getDistribuicao() + 1) % 3));
+            PontosDoCenario.limpa();
+            GeraPontos(QtdDePontos, Ponto(0,0), Ponto(500,500));
+            GeraFechoConvexo(PontosDoCenario, ConvexHull);
+            ConstroiQuadTree();
+            ConsultaCampoDeVisao();
+            break;
+        case 'i':
+            ConsultaIncremental = !ConsultaIncremental;
+            cout << "Consulta incremental: " << (ConsultaIncremental ? "ligada" : "desligada") << endl;
+            ConsultaCampoDeVisao();
+            break;
+        case 'v':
+            UsaVarredura = !UsaVarredura;
+            cout << "Varredura ate " << LIMITE_DA_VARREDURA << " pontos: "
+                 << (UsaVarredura ? "ligada" : "desligada") << endl;
+            ConsultaCampoDeVisao();
+            break;
+        case 'k':
+        case 'K':
+            // Quantidade de vizinhos mais proximos
+            KVizinhos = (key == 'k') ? min(KVizinhos*2, 1024) : max(1, KVizinhos/2);
+            ConsultaCampoDeVisao();
+            break;
+        case '+':
+        case '-':
+            // Capacidade das folhas da quadtree
+            QuadTree.setCapacidadeDaFolha(key == '+' ? QuadTree.getCapacidadeDaFolha()*2
+                                                     : max(1, QuadTree.getCapacidadeDaFolha()/2));
+            ConstroiQuadTree();
+            ConsultaCampoDeVisao();
+            break;
 		default:
 			break;
 	}
@@ -340,6 +558,7 @@ void arrow_keys ( int a_keys, int x, int y )
 			break;
 	}
     PosicionaTrianguloDoCampoDeVisao();
+    ConsultaCampoDeVisao(true);
     cout << "Triangulo Base: " << endl;
     TrianguloBase.imprimeVertices();
     glutPostRedisplay();
@@ -383,6 +602,14 @@ int  main ( int argc, char** argv )
     cout << "Programa OpenGL" << endl;
 
     glutInit            ( &argc, argv );
+
+    if (argc > 1)
+        QtdDePontos = max(1L, atol(argv[1]));
+    DistribuicaoDosPontos Distribuicao;
+    if (argc > 2 && DistribuicaoPeloNome(argv[2], Distribuicao))
+        Gerador.setDistribuicao(Distribuicao);
+    if (argc > 3)
+        Gerador.setSemente(strtoull(argv[3], NULL, 10));
     glutInitDisplayMode (GLUT_DOUBLE | GLUT_DEPTH | GLUT_RGB );
     glutInitWindowPosition (0,0);
 
@@ -0,0 +1,218 @@
+//
+//  QuadTreeDePontos.cpp
+//  OpenGLTest
+//
+
+#include <algorithm>
+#include "QuadTreeDePontos.h"
+
+const int QuadTreeDePontos::NULO;
+
+// Pontos repetidos nunca se separam; o limite evita dividir para sempre
+static const int PROFUNDIDADE_MAXIMA = 24;
+
+QuadTreeDePontos::QuadTreeDePontos(int capacidadeDaFolha)
+{
+    CapacidadeDaFolha = max(1, capacidadeDaFolha);
+    Profundidade = 0;
+}
+
+void QuadTreeDePontos::setCapacidadeDaFolha(int c)
+{
+    if (c >= 1)
+        CapacidadeDaFolha = c;
+}
+
+void QuadTreeDePontos::Constroi(const vector<Ponto> &P)
+{
+    int n = (int)P.size();
+    Nos.clear();
+    Profundidade = 0;
+    Indices.resize(n);
+    for (int i = 0; i < n; i++)
+        Indices[i] = i;
+
+    No Raiz;
+    Raiz.Caixa = (n > 0) ? AABB::DosPontos(P.data(), n) : AABB();
+    Raiz.Filho = NULO;
+    Raiz.Inicio = 0;
+    Raiz.Fim = n;
+    Nos.push_back(Raiz);
+    divide(0, 0, P);
+
+    X.resize(n);
+    Y.resize(n);
+    for (int k = 0; k < n; k++)
+    {
+        X[k] = P[Indices[k]].x;
+        Y[k] = P[Indices[k]].y;
+    }
+}
+
+// Separa os pontos do no em quatro quadrantes (abaixo/acima do meio em
+// y, depois esquerda/direita em x) e cria os filhos na ordem:
+// inferior esquerdo, inferior direito, superior esquerdo, superior direito
+void QuadTreeDePontos::divide(int n, int profundidade, const vector<Ponto> &P)
+{
+    Profundidade = max(Profundidade, profundidade);
+    int inicio = Nos[n].Inicio, fim = Nos[n].Fim;
+    if (fim - inicio <= CapacidadeDaFolha || profundidade >= PROFUNDIDADE_MAXIMA)
+        return;
+
+    AABB B = Nos[n].Caixa;
+    float meioX = (B.minX + B.maxX) * 0.5f;
+    float meioY = (B.minY + B.maxY) * 0.5f;
+
+    int *ini = Indices.data() + inicio;
+    int *fi = Indices.data() + fim;
+    int *corteY = partition(ini, fi, [&](int i) { return P[i].y < meioY; });
+    int *corteX0 = partition(ini, corteY, [&](int i) { return P[i].x < meioX; });
+    int *corteX1 = partition(corteY, fi, [&](int i) { return P[i].x < meioX; });
+
+    int limites[5] = {inicio, (int)(corteX0 - Indices.data()), (int)(corteY - Indices.data()),
+                      (int)(corteX1 - Indices.data()), fim};
+    AABB caixas[4] = {AABB(B.minX, B.minY, meioX, meioY), AABB(meioX, B.minY, B.maxX, meioY),
+                      AABB(B.minX, meioY, meioX, B.maxY), AABB(meioX, meioY, B.maxX, B.maxY)};
+
+    int primeiro = (int)Nos.size();
+    Nos[n].Filho = primeiro;
+    for (int q = 0; q < 4; q++)
+    {
+        No F;
+        F.Caixa = caixas[q];
+        F.Filho = NULO;
+        F.Inicio = limites[q];
+        F.Fim = limites[q + 1];
+        Nos.push_back(F);
+    }
+    for (int q = 0; q < 4; q++)
+        divide(primeiro + q, profundidade + 1, P);
+}
+
+void QuadTreeDePontos::PontosNoTriangulo(const TrianguloDeConsulta &T, vector<int> &Dentro,
+                                         ContadoresDaConsulta *Contadores) const
+{
+    Dentro.clear();
+    if (Nos.empty())
+        return;
+    long visitados = 0, testados = 0, emBloco = 0;
+    Pilha.clear();
+    Pilha.push_back(0);
+    while (!Pilha.empty())
+    {
+        const No &N = Nos[Pilha.back()];
+        Pilha.pop_back();
+        if (N.Inicio == N.Fim)
+            continue;
+        visitados++;
+        if (!T.intersectaCaixa(N.Caixa))
+            continue;
+        if (T.contemCaixa(N.Caixa))
+        {
+            Dentro.insert(Dentro.end(), Indices.begin() + N.Inicio, Indices.begin() + N.Fim);
+            emBloco += N.Fim - N.Inicio;
+        }
+        else if (N.Filho == NULO)
+        {
+            AcrescentaPontosNoTriangulo(&X[N.Inicio], &Y[N.Inicio], &Indices[N.Inicio],
+                                        N.Fim - N.Inicio, T, Dentro);
+            testados += N.Fim - N.Inicio;
+        }
+        else
+        {
+            for (int q = 0; q < 4; q++)
+                Pilha.push_back(N.Filho + q);
+        }
+    }
+
+    if (Contadores)
+    {
+        Contadores->NosVisitados += visitados;
+        Contadores->PontosTestados += testados;
+        Contadores->PontosAceitosEmBloco += emBloco;
+    }
+}
+
+// 0: caixa fora do triangulo, 2: inteira dentro, 1: cortada por ele.
+// Os filhos de uma caixa fora ou inteira dentro herdam a situacao.
+static inline int Situacao(const TrianguloDeConsulta &T, const AABB &B, int doPai)
+{
+    if (doPai != 1)
+        return doPai;
+    if (!T.intersectaCaixa(B))
+        return 0;
+    return T.contemCaixa(B) ? 2 : 1;
+}
+
+void QuadTreeDePontos::PontosQueMudaram(const TrianguloDeConsulta &Antes, const TrianguloDeConsulta &Depois,
+                                        vector<int> &Entraram, vector<int> &Sairam,
+                                        ContadoresDaConsulta *Contadores) const
+{
+    Entraram.clear();
+    Sairam.clear();
+    if (Nos.empty())
+        return;
+
+    long visitados = 0, testados = 0, emBloco = 0;
+    Pilha.clear();
+    PilhaDeSituacoes.clear();
+    Pilha.push_back(0);
+    PilhaDeSituacoes.push_back(1 * 3 + 1);
+    while (!Pilha.empty())
+    {
+        const No &N = Nos[Pilha.back()];
+        int doPai = PilhaDeSituacoes.back();
+        Pilha.pop_back();
+        PilhaDeSituacoes.pop_back();
+        if (N.Inicio == N.Fim)
+            continue;
+        visitados++;
+        int antes = Situacao(Antes, N.Caixa, doPai / 3);
+        int depois = Situacao(Depois, N.Caixa, doPai % 3);
+        if (antes == depois && antes != 1)
+            continue; // nenhum ponto do no muda
+        if (antes != 1 && depois != 1)
+        {
+            vector<int> &Destino = (depois == 2) ? Entraram : Sairam;
+            for (int k = N.Inicio; k < N.Fim; k++)
+                Destino.push_back(k);
+            emBloco += N.Fim - N.Inicio;
+        }
+        else if (N.Filho == NULO)
+        {
+            for (int k = N.Inicio; k < N.Fim; k++)
+            {
+                bool estava = (antes == 2) || (antes == 1 && Antes.contem(X[k], Y[k]));
+                bool esta = (depois == 2) || (depois == 1 && Depois.contem(X[k], Y[k]));
+                if (esta && !estava)
+                    Entraram.push_back(k);
+                else if (estava && !esta)
+                    Sairam.push_back(k);
+            }
+            testados += N.Fim - N.Inicio;
+        }
+        else
+        {
+            for (int q = 0; q < 4; q++)
+            {
+                Pilha.push_back(N.Filho + q);
+                PilhaDeSituacoes.push_back((unsigned char)(antes * 3 + depois));
+            }
+        }
+    }
+
+    if (Contadores)
+    {
+        Contadores->NosVisitados += visitados;
+        Contadores->PontosTestados += testados;
+        Contadores->PontosAceitosEmBloco += emBloco;
+    }
+}
+
+void QuadTreeDePontos::obtemFolhas(vector<AABB> &Caixas) const
+{
+    Caixas.clear();
+    for (size_t n = 0; n < Nos.size(); n++)
+        if (Nos[n].Filho == NULO && Nos[n].Inicio < Nos[n].Fim)
+            Caixas.push_back(Nos[n].Caixa);
+}
@@ -0,0 +1,84 @@
+//
+//  QuadTreeDePontos.h
+//  OpenGLTest
+//
+//  Quadtree de pontos para consultas "quais pontos estao dentro do
+//  triangulo". Cada no divide a sua caixa em quatro quadrantes iguais
+//  ate ter no maximo CapacidadeDaFolha pontos.
+//
+//  Os pontos sao copiados para X[] e Y[] na ordem dos nos, de modo
+//  que os pontos de qualquer no ocupam um intervalo contiguo
+//  [Inicio, Fim). Assim uma caixa inteiramente dentro do triangulo eh
+//  aceita copiando o intervalo, sem testar ponto a ponto.
+//
+//      QuadTreeDePontos Q(16);
+//      Q.Constroi(Pontos);
+//      Q.PontosNoTriangulo(TrianguloDeConsulta(A, B, C), Dentro, &Contadores);
+//
+
+#ifndef QuadTreeDePontos_hpp
+#define QuadTreeDePontos_hpp
+
+#include <vector>
+using namespace std;
+
+#include "Ponto.h"
+#include "AABB.h"
+#include "TrianguloDeConsulta.h"
+
+class QuadTreeDePontos
+{
+    struct No
+    {
+        AABB Caixa;
+        int Filho;        // primeiro dos quatro filhos consecutivos; NULO nas folhas
+        int Inicio, Fim;  // pontos do no em X, Y e Indices
+    };
+
+    vector<No> Nos;
+    vector<float> X, Y;   // pontos na ordem dos nos
+    vector<int> Indices;  // posicao de cada ponto no vetor original
+    int CapacidadeDaFolha;
+    int Profundidade;
+    mutable vector<int> Pilha;
+    mutable vector<unsigned char> PilhaDeSituacoes;
+
+    void divide(int n, int profundidade, const vector<Ponto> &P);
+public:
+    static const int NULO = -1;
+
+    QuadTreeDePontos(int capacidadeDaFolha = 16);
+
+    // Vale a partir da proxima construcao
+    void setCapacidadeDaFolha(int c);
+    int getCapacidadeDaFolha() const { return CapacidadeDaFolha; }
+
+    void Constroi(const vector<Ponto> &P);
+
+    // "Dentro" recebe os indices (no vetor original) dos pontos dentro
+    // ou na borda do triangulo, sem ordem definida
+    void PontosNoTriangulo(const TrianguloDeConsulta &T, vector<int> &Dentro,
+                           ContadoresDaConsulta *Contadores = nullptr) const;
+
+    // Compara dois triangulos: "Entraram" recebe os pontos dentro de
+    // Depois e fora de Antes, "Sairam" o contrario. So sao visitados os
+    // nos que cortam a diferenca simetrica dos dois; uma caixa dentro
+    // de um e fora do outro muda inteira, sem testar os pontos.
+    // Os pontos saem como posicoes na ordem da arvore (ver getIndice),
+    // que ficam proximas para pontos proximos.
+    void PontosQueMudaram(const TrianguloDeConsulta &Antes, const TrianguloDeConsulta &Depois,
+                          vector<int> &Entraram, vector<int> &Sairam,
+                          ContadoresDaConsulta *Contadores = nullptr) const;
+
+    // Posicao k na ordem da arvore -> indice no vetor original
+    int getIndice(int k) const { return Indices[k]; }
+    int getNroDePontos() const { return (int)Indices.size(); }
+
+    int getNroDeNos() const { return (int)Nos.size(); }
+    int getProfundidade() const { return Profundidade; }
+
+    // Caixas das folhas com pontos, para desenho
+    void obtemFolhas(vector<AABB> &Caixas) const;
+};
+
+#endif /* QuadTreeDePontos_hpp */
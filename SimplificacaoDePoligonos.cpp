@@ -0,0 +1,265 @@
+//
+//  SimplificacaoDePoligonos.cpp
+//  OpenGLTest
+//
+
+#include <algorithm>
+#include <queue>
+#include <cmath>
+using namespace std;
+
+#include "SimplificacaoDePoligonos.h"
+#include "DivisaoEmBlocos.h"
+
+// Para de criar niveis quando o poligono fica com menos que isto
+static const unsigned long VERTICES_MIN_DO_NIVEL = 8;
+
+// Quadrado da distancia de P ao segmento A-B
+static double Distancia2AoSegmento(const Ponto &P, const Ponto &A, const Ponto &B)
+{
+    double dx = (double)B.x - A.x, dy = (double)B.y - A.y;
+    double px = (double)P.x - A.x, py = (double)P.y - A.y;
+    double comp2 = dx * dx + dy * dy;
+    double t = (comp2 > 0) ? (px * dx + py * dy) / comp2 : 0;
+    t = max(0.0, min(1.0, t));
+    double ex = px - t * dx, ey = py - t * dy;
+    return ex * ex + ey * ey;
+}
+
+// **********************************************************************
+//  Douglas-Peucker
+// **********************************************************************
+
+// Marca em "Mantem" os vertices da cadeia P[i..j] (indices modulo n)
+static void DouglasPeuckerCadeia(const vector<Ponto> &P, int i, int j, double tol2, vector<char> &Mantem)
+{
+    int n = (int)P.size();
+    // Pilha explicita: cadeias longas e pouco tortuosas estourariam a
+    // pilha de chamadas com recursao
+    vector<pair<int, int> > Pilha;
+    Pilha.push_back(make_pair(i, j));
+    while (!Pilha.empty())
+    {
+        int a = Pilha.back().first, b = Pilha.back().second;
+        Pilha.pop_back();
+        int comprimento = (b - a + n) % n;
+        if (comprimento < 2)
+            continue;
+        double dMax = -1;
+        int kMax = -1;
+        for (int s = 1; s < comprimento; s++)
+        {
+            int k = (a + s) % n;
+            double d = Distancia2AoSegmento(P[k], P[a], P[b]);
+            if (d > dMax)
+            {
+                dMax = d;
+                kMax = k;
+            }
+        }
+        if (dMax > tol2)
+        {
+            Mantem[kMax] = 1;
+            Pilha.push_back(make_pair(a, kMax));
+            Pilha.push_back(make_pair(kMax, b));
+        }
+    }
+}
+
+void SimplificaDouglasPeucker(const vector<Ponto> &P, float tolerancia, vector<Ponto> &Saida)
+{
+    Saida.clear();
+    int n = (int)P.size();
+    if (n <= 3)
+    {
+        Saida = P;
+        return;
+    }
+    // Divide o poligono em duas cadeias: do vertice 0 ao vertice mais
+    // distante dele, e de volta
+    int oposto = 1;
+    double dMax = -1;
+    for (int k = 1; k < n; k++)
+    {
+        double dx = P[k].x - P[0].x, dy = P[k].y - P[0].y;
+        double d = dx * dx + dy * dy;
+        if (d > dMax)
+        {
+            dMax = d;
+            oposto = k;
+        }
+    }
+    vector<char> Mantem(n, 0);
+    Mantem[0] = Mantem[oposto] = 1;
+    double tol2 = (double)tolerancia * tolerancia;
+    DouglasPeuckerCadeia(P, 0, oposto, tol2, Mantem);
+    DouglasPeuckerCadeia(P, oposto, 0, tol2, Mantem);
+
+    // Garante um triangulo: acrescenta o vertice mais distante da corda
+    int mantidos = 0;
+    for (int k = 0; k < n; k++)
+        mantidos += Mantem[k];
+    if (mantidos < 3)
+    {
+        double d3 = -1;
+        int k3 = -1;
+        for (int k = 0; k < n; k++)
+        {
+            double d = Distancia2AoSegmento(P[k], P[0], P[oposto]);
+            if (!Mantem[k] && d > d3)
+            {
+                d3 = d;
+                k3 = k;
+            }
+        }
+        Mantem[k3] = 1;
+    }
+    for (int k = 0; k < n; k++)
+        if (Mantem[k])
+            Saida.push_back(P[k]);
+}
+
+// **********************************************************************
+//  Visvalingam-Whyatt
+// **********************************************************************
+static double AreaDoTriangulo(const Ponto &A, const Ponto &B, const Ponto &C)
+{
+    return fabs(((double)B.x - A.x) * ((double)C.y - A.y) - ((double)B.y - A.y) * ((double)C.x - A.x)) * 0.5;
+}
+
+void SimplificaVisvalingam(const vector<Ponto> &P, float tolerancia, vector<Ponto> &Saida)
+{
+    Saida.clear();
+    int n = (int)P.size();
+    if (n <= 3)
+    {
+        Saida = P;
+        return;
+    }
+    // Lista circular duplamente encadeada + heap de minimo com remocao
+    // preguicosa: uma entrada vale so se a area ainda for a atual
+    vector<int> Ant(n), Prox(n);
+    vector<double> Area(n);
+    vector<char> Removido(n, 0);
+    typedef pair<double, int> EntradaDoHeap;
+    priority_queue<EntradaDoHeap, vector<EntradaDoHeap>, greater<EntradaDoHeap> > Heap;
+    for (int k = 0; k < n; k++)
+    {
+        Ant[k] = (k + n - 1) % n;
+        Prox[k] = (k + 1) % n;
+        Area[k] = AreaDoTriangulo(P[Ant[k]], P[k], P[Prox[k]]);
+        Heap.push(make_pair(Area[k], k));
+    }
+
+    double limite = (double)tolerancia * tolerancia;
+    int restantes = n;
+    while (restantes > 3 && !Heap.empty())
+    {
+        EntradaDoHeap e = Heap.top();
+        int k = e.second;
+        if (Removido[k] || e.first != Area[k])
+        {
+            Heap.pop();
+            continue;
+        }
+        if (e.first >= limite)
+            break;
+        Heap.pop();
+        Removido[k] = 1;
+        restantes--;
+        int a = Ant[k], b = Prox[k];
+        Prox[a] = b;
+        Ant[b] = a;
+        // A area dos vizinhos nunca diminui abaixo da do removido, para
+        // que a ordem de remocao seja monotona
+        Area[a] = max(e.first, AreaDoTriangulo(P[Ant[a]], P[a], P[b]));
+        Area[b] = max(e.first, AreaDoTriangulo(P[a], P[b], P[Prox[b]]));
+        Heap.push(make_pair(Area[a], a));
+        Heap.push(make_pair(Area[b], b));
+    }
+    for (int k = 0; k < n; k++)
+        if (!Removido[k])
+            Saida.push_back(P[k]);
+}
+
+// **********************************************************************
+//  Piramide
+// **********************************************************************
+static void SimplificaNivel(const vector<Ponto> *Original, MetodoDeSimplificacao metodo,
+                            float tolerancia, vector<Ponto> *Saida)
+{
+    if (metodo == SIMPLIFICA_VISVALINGAM)
+        SimplificaVisvalingam(*Original, tolerancia, *Saida);
+    else
+        SimplificaDouglasPeucker(*Original, tolerancia, *Saida);
+}
+
+void PiramideDePoligonos::Constroi(Poligono &P, MetodoDeSimplificacao metodo,
+                                   float toleranciaBase, int maxNiveis)
+{
+    Niveis.clear();
+    Tolerancias.clear();
+    const vector<Ponto> &Original = P.getVertices();
+    if (toleranciaBase <= 0 && !Original.empty())
+    {
+        Ponto Min, Max;
+        P.obtemLimites(Min, Max);
+        Ponto D = Max - Min;
+        toleranciaBase = sqrt(D.x * D.x + D.y * D.y) / 65536.0f;
+    }
+    if (toleranciaBase <= 0)
+        toleranciaBase = 1;
+
+    Niveis.resize(1);
+    Niveis[0].reservaVertices(Original.size());
+    for (size_t i = 0; i < Original.size(); i++)
+        Niveis[0].insereVertice(Original[i]);
+    Tolerancias.push_back(0);
+
+    // Cada nivel eh simplificado a partir do original; os niveis nao
+    // dependem uns dos outros e sao calculados em levas de um por
+    // nucleo. Para depois do primeiro nivel que ja ficou com poucos
+    // vertices: os seguintes nao seriam usados, e so os da mesma leva
+    // chegam a ser calculados.
+    int nNiveis = max(1, maxNiveis);
+    int nThreads = ThreadsDisponiveis(0);
+    int k = 1;
+    while (k < nNiveis && Niveis.back().getNVertices() > VERTICES_MIN_DO_NIVEL)
+    {
+        int naLeva = min(nThreads, nNiveis - k);
+        vector<vector<Ponto> > Simplificados(naLeva);
+        vector<float> ToleranciasDaLeva(naLeva);
+        for (int b = 0; b < naLeva; b++)
+            ToleranciasDaLeva[b] = toleranciaBase * (float)(1 << (k + b - 1));
+        ExecutaEmBlocos(naLeva, naLeva, [&](int b, long, long) {
+            SimplificaNivel(&Original, metodo, ToleranciasDaLeva[b], &Simplificados[b]);
+        });
+        for (int b = 0; b < naLeva && Niveis.back().getNVertices() > VERTICES_MIN_DO_NIVEL; b++, k++)
+        {
+            Niveis.push_back(Poligono());
+            Poligono &N = Niveis.back();
+            N.reservaVertices(Simplificados[b].size());
+            for (size_t i = 0; i < Simplificados[b].size(); i++)
+                N.insereVertice(Simplificados[b][i]);
+            Tolerancias.push_back(ToleranciasDaLeva[b]);
+        }
+    }
+}
+
+int PiramideDePoligonos::EscolheNivel(float unidadesPorPixel) const
+{
+    int nivel = 0;
+    for (int k = 1; k < (int)Tolerancias.size(); k++)
+        if (Tolerancias[k] <= unidadesPorPixel)
+            nivel = k;
+    return nivel;
+}
+
+unsigned long PiramideDePoligonos::desenhaPoligono(float unidadesPorPixel)
+{
+    if (Niveis.empty())
+        return 0;
+    Poligono &N = Niveis[EscolheNivel(unidadesPorPixel)];
+    N.desenhaPoligono();
+    return N.getNVertices();
+}
@@ -0,0 +1,67 @@
+//
+//  SimplificacaoDePoligonos.h
+//  OpenGLTest
+//
+//  Simplificacao de poligonos fechados e piramide de niveis de
+//  detalhe (LOD) para o desenho.
+//
+//  Metodos:
+//   - Douglas-Peucker: mantem os vertices que se afastam mais do que
+//     a tolerancia da corda que os liga;
+//   - Visvalingam-Whyatt: remove, um a um, os vertices que formam o
+//     triangulo de menor area com os vizinhos, enquanto essa area for
+//     menor que tolerancia^2.
+//
+//  A piramide guarda o poligono original (nivel 0) e versoes com
+//  tolerancias que dobram a cada nivel. Os niveis sao calculados uma
+//  vez, em paralelo, e no desenho escolhe-se o nivel mais grosso cujo
+//  erro ainda fica abaixo de um pixel:
+//
+//      Piramide.Constroi(Mapa, SIMPLIFICA_DOUGLAS_PEUCKER);
+//      ...
+//      Piramide.desenhaPoligono(unidadesPorPixel);
+//
+
+#ifndef SimplificacaoDePoligonos_hpp
+#define SimplificacaoDePoligonos_hpp
+
+#include <vector>
+using namespace std;
+
+#include "Ponto.h"
+#include "Poligono.h"
+
+enum MetodoDeSimplificacao
+{
+    SIMPLIFICA_DOUGLAS_PEUCKER,
+    SIMPLIFICA_VISVALINGAM
+};
+
+// Simplifica o poligono fechado P; o resultado tem pelo menos 3
+// vertices (se P tiver pelo menos 3)
+void SimplificaDouglasPeucker(const vector<Ponto> &P, float tolerancia, vector<Ponto> &Saida);
+void SimplificaVisvalingam(const vector<Ponto> &P, float tolerancia, vector<Ponto> &Saida);
+
+class PiramideDePoligonos
+{
+    vector<Poligono> Niveis;
+    vector<float> Tolerancias; // Tolerancias[0] == 0 (original)
+public:
+    // Com toleranciaBase <= 0 usa a diagonal da caixa envolvente / 2^16.
+    // Os niveis vao dobrando a tolerancia ate sobrarem poucos vertices
+    // ou atingir maxNiveis.
+    void Constroi(Poligono &P, MetodoDeSimplificacao metodo,
+                  float toleranciaBase = 0, int maxNiveis = 20);
+
+    int getNroDeNiveis() const { return (int)Niveis.size(); }
+    float getTolerancia(int nivel) const { return Tolerancias[nivel]; }
+    Poligono &getNivel(int nivel) { return Niveis[nivel]; }
+
+    // Nivel mais grosso com tolerancia <= unidadesPorPixel
+    int EscolheNivel(float unidadesPorPixel) const;
+
+    // Desenha o nivel escolhido e retorna quantos vertices desenhou
+    unsigned long desenhaPoligono(float unidadesPorPixel);
+};
+
+#endif /* SimplificacaoDePoligonos_hpp */
@@ -16,8 +16,16 @@
 //   com cooldown que diminui conforme o Score aumenta
 // - Limite de inimigos simultâneos em tela
 // - Aspect ratio preservado; player preso ao viewport
-// - Envelope correto (usa Posicao + Pivot)
+// - Envelope correto: cantos do modelo pela mesma matriz do desenho (Matriz2D)
 // - Overlay do player: nariz (frente) e chama (trás) colados e centralizados
+// - Colisão tiro x inimigo com grade uniforme (broadphase); +/- ajusta a célula
+// - Colisão entre envelopes pelo teorema dos eixos separadores (SAT)
+// - Broadphase alternativa: árvore dinâmica de AABBs gordas ('b' alterna)
+// - Modo sem janela (--headless --ticks N --seed S) para medir a simulação;
+//   --carga-fixa mantém os --inimigos N vivos o tempo todo
+// - Simulação em passo fixo (--hz F), desenho interpolado entre passos
+// - Modelos montados uma vez e desenhados com uma display list cada
+// - Entidades agrupadas por modelo: um lote (2 glDrawArrays) por modelo
 // **********************************************************************
 
 #include <iostream>
@@ -29,17 +37,26 @@
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
 
 using namespace std;
 
 #include <GL/glut.h>
 
 #include "Ponto.h"
-#include "Instancia.h"
+#include "Entidades.h"
 #include "ModeloMatricial.h"
+#include "ModeloCompilado.h"
+#include "Matriz2D.h"
 #include "Temporizador.h"
 #include "ListaDeCoresRGB.h"
 #include "Linha.h" // HaInterseccao(...)
+#include "AABB.h"
+#include "GradeEspacial.h"
+#include "ArvoreAABB.h"
+#include "Colisao.h"
 
 // ---------------------------------------------------------------------
 // Estados do jogo
@@ -53,6 +70,15 @@ GameState gState = GameState::MENU;
 Temporizador T;              // animação
 double AccumDeltaT = 0.0;
 double AccumLogic  = 0.0;    // IA/spawn
+
+// Passo fixo da simulação: o tempo real vai para AccumSimulacao e a
+// simulação anda em passos de 1/FrequenciaSimulacao. Se a máquina não
+// acompanha, no máximo MAX_PASSOS_POR_QUADRO passos são executados por
+// quadro e o atraso restante é descartado (evita a "espiral da morte").
+double FrequenciaSimulacao = 60.0;   // Hz, ajustável com --hz
+double AccumSimulacao = 0.0;
+const int MAX_PASSOS_POR_QUADRO = 8;
+long   PassosDescartados = 0;        // passos perdidos pela proteção acima
 double gameTime    = 0.0;
 
 bool   gameActive = false;   // só true no PLAYING
@@ -61,11 +87,10 @@ double goTimer = 0.0;
 
 // Instâncias
 constexpr int MAX_INSTANCIAS = 500;
-constexpr int AREA_DE_BACKUP = 250;
-Instancia Personagens[MAX_INSTANCIAS + AREA_DE_BACKUP];
+ConjuntoDeEntidades Entidades;   // personagens; o jogador eh sempre o indice 0
+Entidade EstadoInicialJogador;   // restaurado quando o jogador eh atingido
 
 ModeloMatricial Modelos[32];
-int nInstancias   = 0;
 int nModelos      = 0;
 
 // Índices de modelos
@@ -79,9 +104,6 @@ constexpr int   MAX_TIROS_INIMIGOS = 100;
 int   Vidas = 3;
 int   Score = 0;
 
-// Dono do tiro (guardar em Pivot.z)
-enum DonoDoTiro { OWNER_NINGUEM = 0, OWNER_JOGADOR = 1, OWNER_INIMIGO = 2 };
-
 // Mundo base (quadrado) e viewport dinâmico
 Ponto Min, Max;          // base: -d..+d
 Ponto ViewMin, ViewMax;  // retângulo ajustado ao aspecto da janela
@@ -94,13 +116,24 @@ float gWorldPerPixelY = 0.05f;
 // Debug
 bool desenhaEnvelope = false;
 
+// Broadphase: grade uniforme reconstruida a cada passo com os inimigos
+float TamanhoCelulaGrade = 4.0f;        // ajustavel com '+' e '-'
+GradeEspacial GradeInimigos(TamanhoCelulaGrade);
+long  TestesDeColisao = 0;              // chamadas de TestaColisao no ultimo passo
+
+// Broadphase alternativa: arvore dinamica mantida entre os passos com
+// os inimigos e os tiros do jogador. ProxyDaEntidade[i] eh a folha da
+// entidade i (ArvoreAABB::NULO se ela nao esta na arvore).
+bool  UsaArvore = false;                // alterna com 'b'; --broadphase arvore
+ArvoreAABB ArvoreColisao;
+vector<int> ProxyDaEntidade;
+long  AtualizacoesDaArvore = 0;         // folhas reinseridas no ultimo passo
+long  TotalAtualizacoesDaArvore = 0;
+
 // RNG
 std::mt19937_64 rng(123456);
 std::uniform_real_distribution<float> u01(0.0f, 1.0f);
 
-// Aux
-int PersonagemAtual = 0;
-
 // Respawn (agendamento gradual)
 int    pendingSpawns = 0;    // quantos ainda faltam entrar gradualmente
 double spawnAccum    = 0.0;  // acumulador de tempo para spawn
@@ -138,8 +171,18 @@ const float BULLET_SCALE        = 0.38f; // bolinha pequena/fina
 const float  PLAYER_FIRE_COOLDOWN = 0.18f; // seg entre tiros
 double gFireCooldownLeft = 0.0;
 
-// Limite de inimigos simultâneos
-const int   MAX_ENEMIES_ONSCREEN = 8;
+// Clarão do player ao ser atingido: tinta avermelhada que some em
+// DURACAO_DO_CLARAO segundos
+const double DURACAO_DO_CLARAO = 0.6;
+double ClaraoDoJogador = 0.0;
+
+// Limite de inimigos simultâneos (o modo sem janela pode aumentar)
+int   MAX_ENEMIES_ONSCREEN = 8;
+
+// Só no modo sem janela (--carga-fixa): o jogador não perde vidas e os
+// inimigos abatidos são repostos entre os passos, fora da medição, para a
+// carga medida ficar no limite pedido em vez de recomeçar a cada fim de jogo
+bool  CargaFixa = false;
 
 // Constante PI local (evita depender de M_PI)
 const float PI_F = 3.14159265358979323846f;
@@ -157,112 +200,81 @@ static inline float dist2(const Ponto& a, const Ponto& b) {
 
 void MantemDentroDosLimites(int idx) {
     // usa o viewport atual (sem “sair da visão”)
-    Personagens[idx].Posicao.x = clampf(Personagens[idx].Posicao.x, ViewMin.x + 0.5f, ViewMax.x - 0.5f);
-    Personagens[idx].Posicao.y = clampf(Personagens[idx].Posicao.y, ViewMin.y + 0.5f, ViewMax.y - 0.5f);
+    Ponto& P = Entidades.Transf[idx].Posicao;
+    P.x = clampf(P.x, ViewMin.x + 0.5f, ViewMax.x - 0.5f);
+    P.y = clampf(P.y, ViewMin.y + 0.5f, ViewMax.y - 0.5f);
 }
 
 int ContaInimigosVivos() {
-    int c = 0;
-    for (int i=0; i<nInstancias; ++i)
-        if (Personagens[i].IdDoModelo >= ID_MODELO_INICIO_NAVES) c++;
-    return c;
+    return Entidades.conta(CAT_INIMIGO);
 }
 
 // ---------------------------------------------------------------------
 // Desenho matricial + cores dos projéteis + tinta do PLAYER
 // ---------------------------------------------------------------------
-void SetaCor(int cor) { defineCor(cor); }
-
-void DesenhaCelula() {
-    glBegin(GL_QUADS);
-      glVertex2f(0,0);
-      glVertex2f(0,1);
-      glVertex2f(1,1);
-      glVertex2f(1,0);
-    glEnd();
-}
-void DesenhaBorda() {
-    glBegin(GL_LINE_LOOP);
-      glVertex2f(0,0);
-      glVertex2f(0,1);
-      glVertex2f(1,1);
-      glVertex2f(1,0);
-    glEnd();
-}
+// Cada modelo é montado uma vez (MontaModelosCompilados) e gravado numa
+// display list (CompilaModelos); o projétil tem uma versão por dono.
+ModeloCompilado ModelosCompilados[32];
+ModeloCompilado ProjetilDoInimigo;
+bool UsaLotes = true;                 // desenho em lotes por modelo; alterna com 'i'
+int  ChamadasDeDesenho = 0;           // no último quadro
 
 bool EhInimigo(int i);
 bool EhTiroDoJogador(int i);
 bool EhTiroDoInimigo(int i);
 
-void DesenhaPersonagemMatricial() {
-    ModeloMatricial MM = Modelos[ Personagens[PersonagemAtual].IdDoModelo ];
-    bool isProjectile = (Personagens[PersonagemAtual].IdDoModelo == ID_MODELO_PROJETIL);
-    bool isPlayer     = (PersonagemAtual == 0);
-    int owner = (int)std::round(Personagens[PersonagemAtual].Pivot.z);
-
-    glPushMatrix();
+void MontaModeloCompilado(int id, ModeloCompilado& MC, const float corDoProjetil[3]) {
+    const ModeloMatricial& MM = Modelos[id];
+    const float branco[3] = {1.0f, 1.0f, 1.0f};
+    MC.limpa();
 
     // ----------------- PROJÉTIL COMO BOLINHA -----------------
-    if (isProjectile) {
-        // centro e raio em coordenadas do "modelo" (antes da escala da Instancia)
+    if (id == ID_MODELO_PROJETIL) {
+        // centro e raio em coordenadas do "modelo" (antes da escala da entidade)
         float cx = MM.nColunas * 0.5f;
         float cy = MM.nLinhas  * 0.5f;
         float r  = 0.48f * std::min(MM.nColunas, MM.nLinhas);
-
-        // cor por dono
-        if (owner == OWNER_JOGADOR) glColor3f(0.1f, 1.0f, 1.0f);     // ciano
-        else                        glColor3f(1.0f, 0.35f, 0.10f);    // laranja
-
-        // preenchimento
-        glBegin(GL_TRIANGLE_FAN);
-          glVertex2f(cx, cy);
-          const int N = 20;
-          for (int k=0; k<=N; ++k) {
-              float a = (2.0f*PI_F * k) / N;
-              glVertex2f(cx + r*cosf(a), cy + r*sinf(a));
-          }
-        glEnd();
-        // borda branca
-        glColor3f(1,1,1);
-        glBegin(GL_LINE_LOOP);
-          const int NB = 20;
-          for (int k=0; k<NB; ++k) {
-              float a = (2.0f*PI_F * k) / NB;
-              glVertex2f(cx + r*cosf(a), cy + r*sinf(a));
-          }
-        glEnd();
-
-        glPopMatrix();
+        MC.adicionaDisco(cx, cy, r, 20, corDoProjetil, branco); // borda branca
         return; // importante: não desenhar “grid” do modelo para projétil
     }
     // ----------------- FIM PROJÉTIL -----------------
 
+    const float tealClaro[3] = {0.2f, 0.95f, 0.85f};  // player: teal claro
+    const float tealEscuro[3] = {0.06f, 0.3f, 0.28f}; // borda escura
+    float trigo[3];
+    obtemCor(Wheat, trigo[0], trigo[1], trigo[2]);
+
     int larg = MM.nColunas;
     int alt  = MM.nLinhas;
-
+    ModeloMatricial& M = Modelos[id];
     for (int i=0;i<alt;i++) {
-        glPushMatrix();
         for (int j=0;j<larg;j++) {
-            int cor = MM.getColor(alt-1-i, j);
-            if (cor != -1) {
-                if (isPlayer) {
-                    glColor3f(0.2f, 0.95f, 0.85f); // player: teal claro
-                    DesenhaCelula();
-                    glColor3f(0.06f, 0.3f, 0.28f); // borda escura
-                    DesenhaBorda();
-                } else {
-                    SetaCor(cor);
-                    DesenhaCelula();
-                    defineCor(Wheat);
-                    DesenhaBorda();
-                }
+            int cor = M.getColor(alt-1-i, j);
+            if (cor == -1) continue;
+            if (id == ID_MODELO_JOGADOR) {
+                MC.adicionaCelula(i, j, tealClaro, tealEscuro);
+            } else {
+                float rgb[3];
+                obtemCor(cor, rgb[0], rgb[1], rgb[2]);
+                MC.adicionaCelula(i, j, rgb, trigo);
             }
-            glTranslatef(1,0,0);
         }
-        glPopMatrix();
-        glTranslatef(0,1,0);
     }
-    glPopMatrix();
+}
+
+void MontaModelosCompilados() {
+    const float ciano[3]   = {0.1f, 1.0f, 1.0f};
+    const float laranja[3] = {1.0f, 0.35f, 0.10f};
+    for (int id=0; id<nModelos; ++id)
+        MontaModeloCompilado(id, ModelosCompilados[id], ciano);
+    MontaModeloCompilado(ID_MODELO_PROJETIL, ProjetilDoInimigo, laranja);
+}
+
+// Requer o contexto OpenGL; não é chamada no modo sem janela
+void CompilaModelos() {
+    for (int id=0; id<nModelos; ++id)
+        ModelosCompilados[id].compila();
+    ProjetilDoInimigo.compila();
 }
 
 // ---------------------------------------------------------------------
@@ -339,6 +351,24 @@ void DrawHUD() {
     DrawBitmapTextLeft(oss.str(), ViewMin.x + 0.5f, ViewMax.y - 1.0f);
     std::string s = "Score: " + std::to_string(Score);
     DrawBitmapTextRight(s, ViewMax.x - 0.5f, ViewMax.y - 1.0f);
+
+    if (desenhaEnvelope) {
+        std::ostringstream dbg;
+        dbg << fixed << setprecision(1);
+        dbg << "Celula: " << TamanhoCelulaGrade
+            << "  |  Testes/passo: " << TestesDeColisao
+            << "  |  Instancias: " << Entidades.tamanho()
+            << "  |  Desenhos: " << ChamadasDeDesenho << (UsaLotes ? " (lotes)" : "")
+            << "  |  Passos descartados: " << PassosDescartados;
+        DrawBitmapTextLeft(dbg.str(), ViewMin.x + 0.5f, ViewMax.y - 2.0f);
+        if (UsaArvore) {
+            std::ostringstream arv;
+            arv << "Arvore: " << ArvoreColisao.getNroDeObjetos() << " objetos"
+                << "  |  Altura: " << ArvoreColisao.getAltura()
+                << "  |  Atualizacoes/passo: " << AtualizacoesDaArvore;
+            DrawBitmapTextLeft(arv.str(), ViewMin.x + 0.5f, ViewMax.y - 3.0f);
+        }
+    }
 }
 
 // MENU ----------------------------------------------------------------
@@ -373,6 +403,9 @@ void DrawHelp() {
     DrawBitmapTextLeft("- Setas ou WASD: girar (A/D ou ←/→), acelerar (W/↑), frear (S/↓)", x, y); y -= 0.8f;
     DrawBitmapTextLeft("- ESPACO: atirar (apos o jogo comecar)", x, y); y -= 0.8f;
     DrawBitmapTextLeft("- E: mostrar/ocultar envelopes", x, y); y -= 0.8f;
+    DrawBitmapTextLeft("- +/-: tamanho da celula da grade de colisao", x, y); y -= 0.8f;
+    DrawBitmapTextLeft("- B: colisao pela grade / pela arvore de AABBs", x, y); y -= 0.8f;
+    DrawBitmapTextLeft("- I: desenho em lotes por modelo / uma entidade por vez", x, y); y -= 0.8f;
     DrawBitmapTextLeft("- ESC: voltar ao menu", x, y);
 }
 
@@ -410,6 +443,8 @@ void CarregaModelos() {
         id++;
     }
     nModelos = max(nModelos, id);
+
+    MontaModelosCompilados();
 }
 
 // ---------------------------------------------------------------------
@@ -417,93 +452,120 @@ void CarregaModelos() {
 // ---------------------------------------------------------------------
 bool HaInterseccao(Ponto A, Ponto B, Ponto C, Ponto D); // decl
 
-void AtualizaEnvelope(int personagem) {
-    Instancia I = Personagens[personagem];
-    ModeloMatricial MM = Modelos[I.IdDoModelo];
+// Matriz do modelo para o mundo: a mesma usada no desenho
+Matriz2D MatrizDaEntidade(const CompTransformacao& Tr, const CompForma& F) {
+    return MatrizDeInstanciamento(Tr.Posicao, F.Pivot, Tr.Rotacao, F.Escala);
+}
 
-    // Vetores base da orientação
-    Ponto dir = I.Direcao;           // "cima" do modelo
-    Ponto right = dir; right.rotacionaZ(90);
+void CalculaEnvelope(const CompTransformacao& Tr, const CompTipo& Tp,
+                     const CompForma& F, CompEnvelope& Env) {
+    const ModeloMatricial& MM = Modelos[Tp.IdDoModelo];
+    Matriz2D M = MatrizDaEntidade(Tr, F);
+
+    // Quatro cantos do retângulo do modelo, levados ao mundo
+    float w = (float)MM.nColunas, h = (float)MM.nLinhas;
+    Env.Canto[0] = M.aplica(Ponto(0, 0));   // lower-left
+    Env.Canto[1] = M.aplica(Ponto(0, h));   // upper-left
+    Env.Canto[2] = M.aplica(Ponto(w, h));   // upper-right
+    Env.Canto[3] = M.aplica(Ponto(w, 0));   // lower-right
+    Env.Caixa = AABB::DosPontos(Env.Canto, 4);
+}
 
-    // Dimensões em mundo
-    float width  = MM.nColunas * I.Escala.x;
-    float height = MM.nLinhas  * I.Escala.y;
+void AtualizaEnvelope(int personagem) {
+    CalculaEnvelope(Entidades.Transf[personagem], Entidades.Tipo[personagem],
+                    Entidades.Forma[personagem], Entidades.Env[personagem]);
+}
 
-    // Offset do pivot em mundo
-    Ponto pivotWorld = right*(I.Pivot.x * I.Escala.x) + dir*(I.Pivot.y * I.Escala.y);
+void DesenhaCaixa(const AABB& B) {
+    glBegin(GL_LINE_LOOP);
+      glVertex2f(B.minX, B.minY);
+      glVertex2f(B.maxX, B.minY);
+      glVertex2f(B.maxX, B.maxY);
+      glVertex2f(B.minX, B.maxY);
+    glEnd();
+}
 
-    // Origem do modelo (canto inferior esquerdo) em mundo
-    Ponto origin = I.Posicao - pivotWorld;
+Ponto DirecaoDaRotacao(float rotacao);
+
+// Caixas da arvore (folhas gordas em verde, nos internos em cinza) e a
+// mira do jogador ate o primeiro inimigo na frente, achado com raio()
+void DesenhaArvoreDeColisao() {
+    static vector<AABB> caixas;
+    static vector<char> folha;
+    ArvoreColisao.obtemCaixas(caixas, folha);
+    for (size_t k=0; k<caixas.size(); ++k) {
+        defineCor(folha[k] ? Green : Gray);
+        DesenhaCaixa(caixas[k]);
+    }
 
-    // Quatro cantos
-    Ponto A = origin;                 // lower-left
-    Ponto B = origin + dir*height;    // upper-left
-    Ponto C = B + right*width;        // upper-right
-    Ponto D = origin + right*width;   // lower-right
+    static vector<AcertoDoRaio> acertos;
+    Ponto P0 = Entidades.Transf[0].Posicao;
+    Ponto P1 = P0 + DirecaoDaRotacao(Entidades.Transf[0].Rotacao) * 60.0f;
+    ArvoreColisao.raio(P0, P1, acertos);
+    float tAlvo = 1.0f;
+    for (const AcertoDoRaio& A : acertos) {
+        float t;
+        if (A.t >= tAlvo) break;
+        if (EhInimigo(A.Dado) && Entidades.Env[A.Dado].Caixa.intersectaSegmento(P0, P1, t))
+            tAlvo = min(tAlvo, t);
+    }
+    Ponto Alvo = P0 + (P1 - P0) * tAlvo;
+    defineCor(Yellow);
+    glBegin(GL_LINES);
+      glVertex2f(P0.x, P0.y);
+      glVertex2f(Alvo.x, Alvo.y);
+    glEnd();
+}
 
-    if (desenhaEnvelope) {
-        defineCor(Red);
+void DesenhaEnvelopes() {
+    defineCor(Red);
+    for (int i=0; i<Entidades.tamanho(); ++i) {
+        const Ponto* E = Entidades.Env[i].Canto;
         glBegin(GL_LINE_LOOP);
-          glVertex2f(A.x,A.y); glVertex2f(B.x,B.y);
-          glVertex2f(C.x,C.y); glVertex2f(D.x,D.y);
+          for (int k=0; k<4; ++k) glVertex2f(E[k].x, E[k].y);
         glEnd();
     }
-
-    Personagens[personagem].Envelope[0] = A;
-    Personagens[personagem].Envelope[1] = B;
-    Personagens[personagem].Envelope[2] = C;
-    Personagens[personagem].Envelope[3] = D;
+    if (UsaArvore && Entidades.tamanho() > 0) DesenhaArvoreDeColisao();
 }
 
-// Implementação: checa interseção entre os 4 lados de cada OOBB
+// Implementação: eixos separadores entre os dois OOBB (ver Colisao.h)
 bool TestaColisao(int Objeto1, int Objeto2) {
-    for (int i = 0; i < 4; ++i) {
-        Ponto A = Personagens[Objeto1].Envelope[i];
-        Ponto B = Personagens[Objeto1].Envelope[(i + 1) % 4];
-        for (int j = 0; j < 4; ++j) {
-            Ponto C = Personagens[Objeto2].Envelope[j];
-            Ponto D = Personagens[Objeto2].Envelope[(j + 1) % 4];
-            if (HaInterseccao(A, B, C, D)) return true;
-        }
-    }
-    return false;
+    return ColisaoOBB(Entidades.Env[Objeto1].Canto, Entidades.Env[Objeto2].Canto);
 }
 
 // ---------------------------------------------------------------------
 // Helpers: centros topo/base do player + overlay (nariz/chama)
 // ---------------------------------------------------------------------
-void GetTopBottomCentersPlayer(Ponto& topCenter, Ponto& bottomCenter) {
-    // Usa a mesma transformação do envelope: origem = Posicao - pivotWorld
-    Instancia& I = Personagens[0];
-    ModeloMatricial& MM = Modelos[I.IdDoModelo];
-
-    Ponto dir = I.Direcao;
-    Ponto right = dir; right.rotacionaZ(90);
-
-    float width  = MM.nColunas * I.Escala.x;
-    float height = MM.nLinhas  * I.Escala.y;
+// Direção de movimento correspondente a um ângulo de rotação
+Ponto DirecaoDaRotacao(float rotacao) {
+    Ponto dir(0,1);
+    dir.rotacionaZ(rotacao);
+    return dir;
+}
 
-    Ponto pivotWorld = right*(I.Pivot.x * I.Escala.x) + dir*(I.Pivot.y * I.Escala.y);
-    Ponto origin = I.Posicao - pivotWorld;
+void GetTopBottomCentersPlayer(const CompTransformacao& Tr, Ponto& topCenter, Ponto& bottomCenter) {
+    // Usa a mesma transformação do desenho e do envelope
+    ModeloMatricial& MM = Modelos[Entidades.Tipo[0].IdDoModelo];
+    Matriz2D M = MatrizDaEntidade(Tr, Entidades.Forma[0]);
 
     // Centros exatos das bordas: frente (topo) e trás (base)
-    topCenter    = origin + dir*height + right*(width*0.5f);
-    bottomCenter = origin + right*(width*0.5f);
+    topCenter    = M.aplica(Ponto(MM.nColunas*0.5f, (float)MM.nLinhas));
+    bottomCenter = M.aplica(Ponto(MM.nColunas*0.5f, 0));
 }
 
-void DrawPlayerOverlay() {
+void DrawPlayerOverlay(const CompTransformacao& Tr) {
     // base exatamente na borda, centralizado
-    Ponto topC, botC; GetTopBottomCentersPlayer(topC, botC);
+    Ponto topC, botC; GetTopBottomCentersPlayer(Tr, topC, botC);
 
-    Instancia& I = Personagens[0];
-    ModeloMatricial& MM = Modelos[I.IdDoModelo];
+    const CompForma& F = Entidades.Forma[0];
+    ModeloMatricial& MM = Modelos[Entidades.Tipo[0].IdDoModelo];
 
-    Ponto dir = I.Direcao;         // frente
+    Ponto dir = DirecaoDaRotacao(Tr.Rotacao);     // frente
     Ponto right = dir; right.rotacionaZ(90);
 
     // Tamanho proporcional ao modelo (funciona com qualquer escala)
-    float width  = MM.nColunas * I.Escala.x;
-    float height = MM.nLinhas  * I.Escala.y;
+    float width  = MM.nColunas * F.Escala.x;
+    float height = MM.nLinhas  * F.Escala.y;
 
     // “Nariz”: triângulo curto, colado na borda frontal
     float noseLen    = std::max(0.35f, height * 0.15f);   // comprimento pra fora
@@ -555,37 +617,59 @@ void DrawPlayerOverlay() {
 // ---------------------------------------------------------------------
 // Instâncias
 // ---------------------------------------------------------------------
+void LimpaArvoreDeColisao() {
+    ArvoreColisao.limpa();
+    ProxyDaEntidade.clear();
+}
+
 void CriaJogador() {
-    int i = 0;
     float ang = -90;
-
-    Personagens[i].Posicao = Ponto(0, 0);          // centro
-    Personagens[i].Escala  = Ponto(0.7f, 0.7f);
-    Personagens[i].Rotacao = ang;
-    Personagens[i].IdDoModelo = ID_MODELO_JOGADOR;
-    Personagens[i].modelo  = DesenhaPersonagemMatricial;
-    Personagens[i].Pivot   = Ponto(2.5f, 0);
-    Personagens[i].Direcao = Ponto(0,1);
-    Personagens[i].Direcao.rotacionaZ(ang);
-    Personagens[i].Velocidade = 0;
-    Personagens[i + AREA_DE_BACKUP] = Personagens[i];
-
-    nInstancias = 1; // conta o jogador
+    Entidade E;
+
+    E.Transf.Posicao = Ponto(0, 0);          // centro
+    E.Transf.Rotacao = ang;
+    E.Forma.Escala   = Ponto(0.7f, 0.7f);
+    E.Forma.Pivot    = Ponto(2.5f, 0);
+    E.Tipo.IdDoModelo = ID_MODELO_JOGADOR;
+    E.Tipo.Dono      = OWNER_NINGUEM;
+    E.Tipo.Categoria = CAT_JOGADOR;
+    E.Vel.Direcao    = Ponto(0,1);
+    E.Vel.Direcao.rotacionaZ(ang);
+    E.Vel.Velocidade = 0;
+    CalculaEnvelope(E.Transf, E.Tipo, E.Forma, E.Env);
+    EstadoInicialJogador = E;
+
+    Entidades.limpa();
+    Entidades.cria(E); // o jogador fica no indice 0
+    LimpaArvoreDeColisao();
 }
 
 void RemoveInstancia(int idx) {
-    if (idx < 0 || idx >= nInstancias) return;
-    if (idx != nInstancias-1) {
-        Personagens[idx] = Personagens[nInstancias-1];
+    if (idx <= 0 || idx >= Entidades.tamanho()) return; // o jogador nunca sai do indice 0
+
+    // A arvore acompanha a troca feita por remove: a folha de idx sai e
+    // a da ultima entidade passa a apontar para idx
+    int ultima = Entidades.tamanho() - 1;
+    int nProxies = (int)ProxyDaEntidade.size();
+    if (idx < nProxies) {
+        if (ProxyDaEntidade[idx] != ArvoreAABB::NULO)
+            ArvoreColisao.remove(ProxyDaEntidade[idx]);
+        ProxyDaEntidade[idx] = ArvoreAABB::NULO;
+        if (idx != ultima && ultima < nProxies) {
+            ProxyDaEntidade[idx] = ProxyDaEntidade[ultima];
+            if (ProxyDaEntidade[idx] != ArvoreAABB::NULO)
+                ArvoreColisao.setDado(ProxyDaEntidade[idx], idx);
+        }
+        ProxyDaEntidade.resize(min(nProxies, ultima));
     }
-    nInstancias--;
+    Entidades.remove(idx);
 }
 
 bool SpawnOneEnemy() {
-    if (nInstancias >= MAX_INSTANCIAS-1) return false;
+    if (Entidades.tamanho() >= MAX_INSTANCIAS-1) return false;
     if (ContaInimigosVivos() >= MAX_ENEMIES_ONSCREEN) return false; // limite de simultâneos
 
-    for (int j=0; j<nInstancias; ++j) AtualizaEnvelope(j);
+    for (int j=0; j<Entidades.tamanho(); ++j) AtualizaEnvelope(j);
 
     std::uniform_real_distribution<float> rx(ViewMin.x+2.0f, ViewMax.x-2.0f);
     std::uniform_real_distribution<float> ry(ViewMin.y+2.0f, ViewMax.y-2.0f);
@@ -594,39 +678,40 @@ bool SpawnOneEnemy() {
 
     const float safeR = 4.0f; // não nascer muito perto do player
 
-    int idx = nInstancias;
+    int idx = Entidades.tamanho();
+    Entidade E;
     bool ok = false;
     for (int tent=0; tent<120 && !ok; ++tent) {
         float ang = rang(rng);
 
-        Personagens[idx].Posicao = Ponto(rx(rng), ry(rng));
-        Personagens[idx].Escala  = Ponto(0.6f, 0.6f);
-        Personagens[idx].Rotacao = ang;
+        E.Transf.Posicao = Ponto(rx(rng), ry(rng));
+        E.Transf.Rotacao = ang;
+        E.Forma.Escala   = Ponto(0.6f, 0.6f);
 
         int vivosNoMomento = std::max(0, idx - PrimeiroInimigo);
         int idNav = ID_MODELO_INICIO_NAVES + (vivosNoMomento % 4);
 
-        Personagens[idx].IdDoModelo = idNav;
-        Personagens[idx].modelo     = DesenhaPersonagemMatricial;
-        Personagens[idx].Pivot      = Ponto(0.5,0);
-        Personagens[idx].Direcao    = Ponto(0,1);
-        Personagens[idx].Direcao.rotacionaZ(ang);
-        Personagens[idx].Velocidade = rvel(rng);
+        E.Tipo.IdDoModelo = idNav;
+        E.Tipo.Dono       = OWNER_NINGUEM;
+        E.Tipo.Categoria  = CAT_INIMIGO;
+        E.Forma.Pivot     = Ponto(0.5,0);
+        E.Vel.Direcao     = Ponto(0,1);
+        E.Vel.Direcao.rotacionaZ(ang);
+        E.Vel.Velocidade  = rvel(rng);
 
-        AtualizaEnvelope(idx);
+        CalculaEnvelope(E.Transf, E.Tipo, E.Forma, E.Env);
 
         ok = true;
-        if (dist2(Personagens[idx].Posicao, Personagens[0].Posicao) < safeR*safeR) ok = false;
+        if (dist2(E.Transf.Posicao, Entidades.Transf[0].Posicao) < safeR*safeR) ok = false;
         if (ok) {
-            for (int j=0; j<nInstancias; ++j) {
-                if (TestaColisao(j, idx)) { ok = false; break; }
+            for (int j=0; j<Entidades.tamanho(); ++j) {
+                if (ColisaoOBB(Entidades.Env[j].Canto, E.Env.Canto)) { ok = false; break; }
             }
         }
     }
     if (!ok) return false;
 
-    Personagens[idx + AREA_DE_BACKUP] = Personagens[idx];
-    nInstancias++;
+    Entidades.cria(E);
     return true;
 }
 
@@ -634,46 +719,42 @@ bool SpawnOneEnemy() {
 // Tiros
 // ---------------------------------------------------------------------
 int ContaTirosDoDono(int dono) {
-    int c=0;
-    for (int i=0; i<nInstancias; ++i) {
-        if (Personagens[i].IdDoModelo == ID_MODELO_PROJETIL &&
-            (int)std::round(Personagens[i].Pivot.z) == dono) c++;
-    }
-    return c;
+    if (dono == OWNER_JOGADOR) return Entidades.conta(CAT_TIRO_JOGADOR);
+    if (dono == OWNER_INIMIGO) return Entidades.conta(CAT_TIRO_INIMIGO);
+    return 0;
 }
 
 void CriaTiro2(int nAtirador) {
-    if (nInstancias >= MAX_INSTANCIAS-1) return;
+    if (Entidades.tamanho() >= MAX_INSTANCIAS-1) return;
 
-    int i = nInstancias;
-    Instancia Atirador = Personagens[nAtirador];
-    float ang = Atirador.Rotacao;
+    Entidade Atirador = Entidades.le(nAtirador);
+    Entidade E;
+    float ang = Atirador.Transf.Rotacao;
 
     // Escala menor para a “bolinha”
-    Personagens[i].Escala   = Ponto(BULLET_SCALE, BULLET_SCALE);
-    Personagens[i].Rotacao  = ang;
-    Personagens[i].IdDoModelo = ID_MODELO_PROJETIL;
-    Personagens[i].modelo   = DesenhaPersonagemMatricial;
-    Personagens[i].Pivot    = Ponto(0.5,0);
+    E.Forma.Escala   = Ponto(BULLET_SCALE, BULLET_SCALE);
+    E.Transf.Rotacao = ang;
+    E.Tipo.IdDoModelo = ID_MODELO_PROJETIL;
+    E.Forma.Pivot    = Ponto(0.5,0);
 
-    Personagens[i].Direcao = Ponto(0,1);
-    Personagens[i].Direcao.rotacionaZ(ang);
+    E.Vel.Direcao = Ponto(0,1);
+    E.Vel.Direcao.rotacionaZ(ang);
 
-    int Altura = Modelos[Atirador.IdDoModelo].nLinhas;
+    int Altura = Modelos[Atirador.Tipo.IdDoModelo].nLinhas;
 
     // sai mais à frente para não colidir com o atirador
-    Ponto P = Atirador.Posicao + (Atirador.Direcao * (Altura * Atirador.Escala.y)) * 1.30f - (Personagens[i].Pivot);
-    Personagens[i].Posicao = P;
+    E.Transf.Posicao = Atirador.Transf.Posicao
+                     + (Atirador.Vel.Direcao * (Altura * Atirador.Forma.Escala.y)) * 1.30f - E.Forma.Pivot;
 
-    int dono = (nAtirador==0) ? OWNER_JOGADOR : OWNER_INIMIGO;
-    Personagens[i].Pivot.z = (float)dono;
+    E.Tipo.Dono = (nAtirador==0) ? OWNER_JOGADOR : OWNER_INIMIGO;
+    E.Tipo.Categoria = (nAtirador==0) ? CAT_TIRO_JOGADOR : CAT_TIRO_INIMIGO;
 
     // velocidade: jogador bem mais rápido
     float base = (nAtirador==0) ? PLAYER_BULLET_SPEED : ENEMY_BULLET_SPEED;
-    Personagens[i].Velocidade = base + (nAtirador==0 ? std::max(0.0f, Atirador.Velocidade*0.3f) : 0.0f);
+    E.Vel.Velocidade = base + (nAtirador==0 ? std::max(0.0f, Atirador.Vel.Velocidade*0.3f) : 0.0f);
 
-    Personagens[i + AREA_DE_BACKUP] = Personagens[i];
-    nInstancias++;
+    CalculaEnvelope(E.Transf, E.Tipo, E.Forma, E.Env);
+    Entidades.cria(E);
 }
 
 void CriaTiro() {
@@ -685,53 +766,114 @@ void CriaTiro() {
 // Lógica (envelopes/colisões/jogo)
 // ---------------------------------------------------------------------
 void AtualizaTodosEnvelopes() {
-    for (int i=0; i<nInstancias; ++i) AtualizaEnvelope(i);
+    for (int i=0; i<Entidades.tamanho(); ++i) AtualizaEnvelope(i);
 }
 
 bool EhTiroDoJogador(int i) {
-    return Personagens[i].IdDoModelo == ID_MODELO_PROJETIL &&
-           (int)std::round(Personagens[i].Pivot.z) == OWNER_JOGADOR;
+    return Entidades.Tipo[i].Categoria == CAT_TIRO_JOGADOR;
 }
 bool EhTiroDoInimigo(int i) {
-    return Personagens[i].IdDoModelo == ID_MODELO_PROJETIL &&
-           (int)std::round(Personagens[i].Pivot.z) == OWNER_INIMIGO;
+    return Entidades.Tipo[i].Categoria == CAT_TIRO_INIMIGO;
 }
 bool EhInimigo(int i) {
-    return Personagens[i].IdDoModelo >= ID_MODELO_INICIO_NAVES;
+    return Entidades.Tipo[i].Categoria == CAT_INIMIGO;
+}
+
+bool EntraNaArvore(int i) {
+    return EhInimigo(i) || EhTiroDoJogador(i);
+}
+
+// Leva para a arvore as entidades novas e as que sairam da caixa gorda
+void AtualizaArvoreDeColisao() {
+    AtualizacoesDaArvore = 0;
+    int n = Entidades.tamanho();
+    if ((int)ProxyDaEntidade.size() < n) ProxyDaEntidade.resize(n, ArvoreAABB::NULO);
+    for (int i=0; i<n; ++i) {
+        if (!EntraNaArvore(i)) continue;
+        int& p = ProxyDaEntidade[i];
+        if (p == ArvoreAABB::NULO) {
+            p = ArvoreColisao.insere(Entidades.Env[i].Caixa, i);
+            AtualizacoesDaArvore++;
+        } else {
+            Ponto deslocamento = Entidades.Transf[i].Posicao - Entidades.TransfAnterior[i].Posicao;
+            if (ArvoreColisao.move(p, Entidades.Env[i].Caixa, deslocamento))
+                AtualizacoesDaArvore++;
+        }
+    }
+    TotalAtualizacoesDaArvore += AtualizacoesDaArvore;
+}
+
+// Pares (tiro do jogador, inimigo) que podem colidir, ordenados por
+// tiro e depois por inimigo: a mesma ordem do teste com todos
+void CandidatosTiroInimigo(vector<pair<int,int>>& candidatos) {
+    candidatos.clear();
+    if (UsaArvore) {
+        static vector<ParDaArvore> pares;
+        AtualizaArvoreDeColisao();
+        ArvoreColisao.obtemPares(pares);
+        for (const ParDaArvore& P : pares) {
+            int i = P.a, j = P.b;
+            if (EhTiroDoJogador(j)) swap(i, j);
+            if (EhTiroDoJogador(i) && EhInimigo(j)) candidatos.push_back(make_pair(i, j));
+        }
+    } else {
+        // So os inimigos que dividem alguma celula da grade com o tiro
+        static vector<int> vizinhos;
+        GradeInimigos.setTamanhoCelula(TamanhoCelulaGrade);
+        GradeInimigos.limpa();
+        for (int j=0; j<Entidades.tamanho(); ++j)
+            if (EhInimigo(j)) GradeInimigos.insere(j, Entidades.Env[j].Caixa);
+        GradeInimigos.fecha();
+        for (int i=0; i<Entidades.tamanho(); ++i) {
+            if (!EhTiroDoJogador(i)) continue;
+            GradeInimigos.obtemCandidatos(Entidades.Env[i].Caixa, vizinhos);
+            for (int j : vizinhos) candidatos.push_back(make_pair(i, j));
+        }
+    }
+    sort(candidatos.begin(), candidatos.end());
 }
 
 void AtualizaJogo() {
     AtualizaTodosEnvelopes();
-
-    // Tiro do jogador x inimigos
-    for (int i=0; i<nInstancias; ) {
-        if (!EhTiroDoJogador(i)) { ++i; continue; }
-        bool hit = false;
-        for (int j=0; j<nInstancias; ++j) {
-            if (!EhInimigo(j)) continue;
-            if (TestaColisao(i, j)) {
-                Score += 100;
-                int a = std::max(i, j);
-                int b = std::min(i, j);
-                RemoveInstancia(a);
-                RemoveInstancia(b);
-                pendingSpawns += (u01(rng) < 0.5f ? 1 : 2); // agenda novos gradualmente
-                AtualizaTodosEnvelopes();
-                hit = true;
-                break;
-            }
+    TestesDeColisao = 0;
+
+    // As remocoes trocam os indices de lugar; por isso primeiro marca
+    // os acertos e so depois remove, do maior indice para o menor
+    static vector<pair<int,int>> candidatos;
+    static vector<char> atingido;
+    static vector<int> remover;
+    CandidatosTiroInimigo(candidatos);
+    atingido.assign(Entidades.tamanho(), 0);
+    remover.clear();
+    for (const pair<int,int>& C : candidatos) {
+        int i = C.first, j = C.second;
+        if (atingido[i] || atingido[j]) continue;
+        TestesDeColisao++;
+        if (TestaColisao(i, j)) {
+            Score += 100;
+            atingido[i] = atingido[j] = 1;
+            remover.push_back(i);
+            remover.push_back(j);
+            pendingSpawns += (u01(rng) < 0.5f ? 1 : 2); // agenda novos gradualmente
         }
-        if (!hit) ++i;
+    }
+    // remove() leva o envelope junto com a entidade e o jogador volta com
+    // o envelope de EstadoInicialJogador: os envelopes continuam valendo
+    if (!remover.empty()) {
+        sort(remover.begin(), remover.end(), greater<int>());
+        for (int idx : remover) RemoveInstancia(idx);
     }
 
     // Tiros de inimigo x jogador
-    for (int i=0; i<nInstancias; ) {
+    for (int i=0; i<Entidades.tamanho(); ) {
         if (!EhTiroDoInimigo(i)) { ++i; continue; }
+        TestesDeColisao++;
         if (TestaColisao(0, i)) {
+            if (CargaFixa) { RemoveInstancia(i); continue; }
             Vidas--;
-            Personagens[0] = Personagens[0 + AREA_DE_BACKUP];
+            ClaraoDoJogador = DURACAO_DO_CLARAO;
+            Entidades.escreve(0, EstadoInicialJogador);
             RemoveInstancia(i);
-            AtualizaTodosEnvelopes();
             if (Vidas <= 0) {
                 gState = GameState::GAMEOVER;
                 gameActive = false;
@@ -743,10 +885,10 @@ void AtualizaJogo() {
     }
 
     // Remove projéteis fora da tela
-    for (int i=0; i<nInstancias; ) {
-        bool tiro = (Personagens[i].IdDoModelo == ID_MODELO_PROJETIL);
+    for (int i=0; i<Entidades.tamanho(); ) {
+        bool tiro = (Entidades.Tipo[i].IdDoModelo == ID_MODELO_PROJETIL);
         if (tiro) {
-            Ponto p = Personagens[i].Posicao;
+            Ponto p = Entidades.Transf[i].Posicao;
             if (p.x < ViewMin.x-2 || p.x > ViewMax.x+2 || p.y < ViewMin.y-2 || p.y > ViewMax.y+2) {
                 RemoveInstancia(i);
                 continue;
@@ -782,8 +924,8 @@ void HandlePlayerInput(float dt) {
 
     float dAng = gPlayerAngVel * dt;
     if (fabs(dAng) > 0.0f) {
-        Personagens[0].Rotacao += dAng;
-        Personagens[0].Direcao.rotacionaZ(dAng);
+        Entidades.Transf[0].Rotacao += dAng;
+        Entidades.Vel[0].Direcao.rotacionaZ(dAng);
     }
 
     // ---- ACELERAÇÃO / FREIO / ATRITO ----
@@ -793,53 +935,51 @@ void HandlePlayerInput(float dt) {
 
     gThrusting = (thrust > 0.0f);
 
-    Personagens[0].Velocidade += thrust * dt;
+    float& vel = Entidades.Vel[0].Velocidade;
+    vel += thrust * dt;
 
     if (thrust <= 0.0f) {
-        float v = Personagens[0].Velocidade;
+        float v = vel;
         float dv = v * DAMPING * dt;
-        Personagens[0].Velocidade = (v > dv) ? (v - dv) : 0.0f;
+        vel = (v > dv) ? (v - dv) : 0.0f;
     }
-    Personagens[0].Velocidade = clampf(Personagens[0].Velocidade, 0.0f, VEL_MAX);
+    vel = clampf(vel, 0.0f, VEL_MAX);
 }
 
 void AtualizaPersonagens(float dt) {
     HandlePlayerInput(dt);
 
-    // Jogador
-    Personagens[0].AtualizaPosicao(dt);
+    // Todos se movem (so le/escreve posicao e velocidade)
+    Entidades.avanca(0, dt);
     MantemDentroDosLimites(0);
 
-    // Inimigos e tiros
-    for (int i=1; i<nInstancias; ++i) {
-        Personagens[i].AtualizaPosicao(dt);
+    // Inimigos rebatem nas bordas
+    for (int i=1; i<Entidades.tamanho(); ++i) {
         if (EhInimigo(i)) {
-            Ponto p = Personagens[i].Posicao;
+            Ponto p = Entidades.Transf[i].Posicao;
             if (p.x <= ViewMin.x+1 || p.x >= ViewMax.x-1) {
-                Personagens[i].Direcao.rotacionaZ(180);
-                Personagens[i].Rotacao += 180;
+                Entidades.Vel[i].Direcao.rotacionaZ(180);
+                Entidades.Transf[i].Rotacao += 180;
             }
             if (p.y <= ViewMin.y+1 || p.y >= ViewMax.y-1) {
-                Personagens[i].Direcao.rotacionaZ(180);
-                Personagens[i].Rotacao += 180;
+                Entidades.Vel[i].Direcao.rotacionaZ(180);
+                Entidades.Transf[i].Rotacao += 180;
             }
             MantemDentroDosLimites(i);
         }
     }
-
-    AtualizaJogo();
 }
 
 void AtualizaInimigosIA(float dt) {
     float pTroca = 0.5f * dt;
 
-    for (int i=1; i<nInstancias; ++i) {
+    for (int i=1; i<Entidades.tamanho(); ++i) {
         if (!EhInimigo(i)) continue;
 
         if (u01(rng) < pTroca) {
             float delta = (u01(rng) * 60.0f) - 30.0f;
-            Personagens[i].Rotacao += delta;
-            Personagens[i].Direcao.rotacionaZ(delta);
+            Entidades.Transf[i].Rotacao += delta;
+            Entidades.Vel[i].Direcao.rotacionaZ(delta);
         }
 
         float pTiro = 0.7f * dt;
@@ -858,6 +998,18 @@ float DynamicSpawnCooldown() {
     return (cd < minc ? minc : cd);
 }
 
+// Cria inimigos até o limite de simultâneos. Uma tentativa pode falhar
+// só por azar no sorteio das posições; depois de algumas seguidas, o
+// resto fica para o próximo passo
+void PreencheInimigosAteOLimite() {
+    const int MAX_FALHAS = 8;
+    int falhas = 0;
+    while (falhas < MAX_FALHAS && ContaInimigosVivos() < MAX_ENEMIES_ONSCREEN) {
+        if (SpawnOneEnemy()) falhas = 0;
+        else falhas++;
+    }
+}
+
 void ProcessaRespawn(float dt) {
     if (pendingSpawns <= 0) return;
 
@@ -870,8 +1022,7 @@ void ProcessaRespawn(float dt) {
     while (pendingSpawns > 0 && spawnAccum >= cd) {
         if (ContaInimigosVivos() >= MAX_ENEMIES_ONSCREEN) break;
 
-        AtualizaTodosEnvelopes();
-        if (SpawnOneEnemy()) pendingSpawns--;
+        if (SpawnOneEnemy()) pendingSpawns--; // ja atualiza os envelopes
         spawnAccum -= cd;
         cd = DynamicSpawnCooldown();
     }
@@ -881,7 +1032,7 @@ void ProcessaRespawn(float dt) {
 // Fluxos de jogo (Menu/Start/Reset)
 // ---------------------------------------------------------------------
 void ResetMatch() {
-    nInstancias = 0;
+    Entidades.limpa();
     Vidas = 3;
     Score = 0;
     gameTime = 0.0;
@@ -889,6 +1040,7 @@ void ResetMatch() {
     spawnAccum = 0.0;
     gPlayerAngVel = 0.0f;
     gFireCooldownLeft = 0.0;
+    ClaraoDoJogador = 0.0;
     CriaJogador();
     AtualizaTodosEnvelopes();
 }
@@ -911,11 +1063,172 @@ void BeginPlaying() {
 // ---------------------------------------------------------------------
 // Renderização
 // ---------------------------------------------------------------------
+// Transformações usadas no desenho: interpoladas entre os dois últimos
+// passos da simulação
+vector<CompTransformacao> TransfDesenho;
+
+void InterpolaTransformacoes(float alfa) {
+    TransfDesenho.resize(Entidades.tamanho());
+    for (int i=0; i<Entidades.tamanho(); ++i)
+        TransfDesenho[i] = Entidades.interpola(i, alfa);
+}
+
+// Desenho agrupado por modelo: um lote por modelo compilado (o último
+// é o projétil do inimigo). Com UsaLotes == false, desenha uma entidade
+// por vez, com a display list do modelo.
+vector<LoteDeInstancias> Lotes;
+
+const ModeloCompilado& ModeloDaEntidade(int i) {
+    const CompTipo& Tp = Entidades.Tipo[i];
+    if (Tp.IdDoModelo == ID_MODELO_PROJETIL && Tp.Dono == OWNER_INIMIGO)
+        return ProjetilDoInimigo;
+    return ModelosCompilados[Tp.IdDoModelo];
+}
+
+int LoteDaEntidade(int i) {
+    const CompTipo& Tp = Entidades.Tipo[i];
+    if (Tp.IdDoModelo == ID_MODELO_PROJETIL && Tp.Dono == OWNER_INIMIGO)
+        return nModelos;
+    return Tp.IdDoModelo;
+}
+
+// Só o player tem tinta: vermelho durante o clarão, voltando ao normal
+bool TintaDaEntidade(int i, float tinta[3]) {
+    tinta[0] = tinta[1] = tinta[2] = 1.0f;
+    if (Entidades.Tipo[i].Categoria != CAT_JOGADOR || ClaraoDoJogador <= 0.0) return false;
+    float t = (float)(ClaraoDoJogador / DURACAO_DO_CLARAO);
+    tinta[1] = tinta[2] = 1.0f - 0.75f * t;
+    return true;
+}
+
+InstanciaDoLote InstanciaDaEntidade(int i) {
+    InstanciaDoLote I;
+    Matriz2D M = MatrizDaEntidade(TransfDesenho[i], Entidades.Forma[i]);
+    I.M[0] = M.a; I.M[1] = M.b; I.M[2] = M.tx;
+    I.M[3] = M.c; I.M[4] = M.d; I.M[5] = M.ty;
+    TintaDaEntidade(i, I.Tinta);
+    return I;
+}
+
+void DesenhaPersonagensEmLotes() {
+    Lotes.resize(nModelos + 1);
+    for (int id=0; id<nModelos; ++id) Lotes[id].Modelo = &ModelosCompilados[id];
+    Lotes[nModelos].Modelo = &ProjetilDoInimigo;
+    for (size_t k=0; k<Lotes.size(); ++k) Lotes[k].limpa();
+
+    for (int i=0; i<Entidades.tamanho(); ++i)
+        Lotes[LoteDaEntidade(i)].adiciona(InstanciaDaEntidade(i));
+    for (size_t k=0; k<Lotes.size(); ++k)
+        ChamadasDeDesenho += Lotes[k].desenha();
+}
+
 void DesenhaPersonagens() {
-    for (int i=0; i<nInstancias; ++i) {
-        PersonagemAtual = i;
-        Personagens[i].desenha();
+    ChamadasDeDesenho = 0;
+    if (UsaLotes) {
+        DesenhaPersonagensEmLotes();
+    } else {
+        // A display list tem as cores fixas; uma entidade com tinta vai
+        // num lote só dela
+        static LoteDeInstancias Tingida;
+        float tinta[3];
+        for (int i=0; i<Entidades.tamanho(); ++i) {
+            if (TintaDaEntidade(i, tinta)) {
+                Tingida.Modelo = &ModeloDaEntidade(i);
+                Tingida.limpa();
+                Tingida.adiciona(InstanciaDaEntidade(i));
+                ChamadasDeDesenho += Tingida.desenha();
+                continue;
+            }
+            // Aplica as transformacoes geometricas no modelo
+            GLfloat matriz_gl[16];
+            MatrizDaEntidade(TransfDesenho[i], Entidades.Forma[i]).paraOpenGL(matriz_gl);
+            glPushMatrix();
+                glMultMatrixf(matriz_gl);
+                ModeloDaEntidade(i).desenha();
+            glPopMatrix();
+            ChamadasDeDesenho++;
+        }
     }
+    if (desenhaEnvelope) DesenhaEnvelopes();
+}
+
+// ---------------------------------------------------------------------
+// Passo da simulação (usado pela janela e pelo modo sem janela)
+// ---------------------------------------------------------------------
+typedef std::chrono::steady_clock Relogio;
+
+// Tempo acumulado (s) em cada fase do passo
+struct TemposDasFases {
+    double IA = 0, Respawn = 0, Movimento = 0, Colisao = 0;
+};
+
+static inline double Segundos(Relogio::time_point a, Relogio::time_point b) {
+    return std::chrono::duration<double>(b - a).count();
+}
+
+void PassoDoJogo(double dt, TemposDasFases* tempos = nullptr) {
+    Entidades.guardaTransformacoes();
+
+    // cooldown de tiro
+    if (gFireCooldownLeft > 0.0) {
+        gFireCooldownLeft -= dt;
+        if (gFireCooldownLeft < 0.0) gFireCooldownLeft = 0.0;
+    }
+
+    if (gState == GameState::COUNTDOWN) {
+        countdownRemaining -= dt;
+        if (countdownRemaining <= 0.0) {
+            countdownRemaining = 0.0;
+            BeginPlaying(); // só aqui começa a entrar inimigo, gradualmente
+        }
+    } else if (gState == GameState::PLAYING) {
+        gameTime += dt;
+        if (goTimer > 0.0) goTimer -= dt;
+        if (ClaraoDoJogador > 0.0) ClaraoDoJogador = max(0.0, ClaraoDoJogador - dt);
+
+        Relogio::time_point t0, t1, t2, t3, t4;
+        if (tempos) t0 = Relogio::now();
+        AccumLogic += dt;
+        bool passoLogico = (AccumLogic >= 0.1);
+        float step = (float)AccumLogic;
+        if (passoLogico) {
+            AccumLogic = 0.0f;
+            AtualizaInimigosIA(step);
+        }
+        if (tempos) t1 = Relogio::now();
+        if (passoLogico) ProcessaRespawn(step);
+        if (tempos) t2 = Relogio::now();
+        AtualizaPersonagens((float)dt);
+        if (tempos) t3 = Relogio::now();
+        AtualizaJogo();
+        if (tempos) {
+            t4 = Relogio::now();
+            tempos->IA        += Segundos(t0, t1);
+            tempos->Respawn   += Segundos(t1, t2);
+            tempos->Movimento += Segundos(t2, t3);
+            tempos->Colisao   += Segundos(t3, t4);
+        }
+    }
+}
+
+// Hash FNV-1a do estado da partida; serve para comparar execucoes
+unsigned long long HashDoEstado() {
+    unsigned long long h = 1469598103934665603ull;
+    auto mistura = [&h](const void* dados, size_t n) {
+        const unsigned char* b = (const unsigned char*)dados;
+        for (size_t k=0; k<n; ++k) { h ^= b[k]; h *= 1099511628211ull; }
+    };
+    int n = Entidades.tamanho();
+    mistura(&n, sizeof(n));
+    mistura(&Score, sizeof(Score));
+    mistura(&Vidas, sizeof(Vidas));
+    for (int i=0; i<n; ++i) {
+        mistura(&Entidades.Transf[i].Posicao.x, sizeof(float));
+        mistura(&Entidades.Transf[i].Posicao.y, sizeof(float));
+        mistura(&Entidades.Transf[i].Rotacao, sizeof(float));
+        mistura(&Entidades.Tipo[i].Categoria, sizeof(int));
+    }
+    return h;
 }
 
 // ---------------------------------------------------------------------
@@ -931,9 +1244,12 @@ void display() {
     } else if (gState == GameState::HELP) {
         DrawHelp();
     } else {
+        // fração do próximo passo já decorrida
+        float alfa = (float)(AccumSimulacao * FrequenciaSimulacao);
+        InterpolaTransformacoes(std::min(1.0f, alfa));
         DesenhaPersonagens();
         // overlay do player (clarifica frente/trás)
-        if (nInstancias > 0) DrawPlayerOverlay();
+        if (Entidades.tamanho() > 0) DrawPlayerOverlay(TransfDesenho[0]);
 
         DrawHUD();
         DrawCountdownOverlay();
@@ -942,7 +1258,8 @@ void display() {
     glutSwapBuffers();
 }
 
-void reshape(int w, int h) {
+// Ajusta o retângulo visível ao aspecto da janela (sem chamadas OpenGL)
+void CalculaVisao(int w, int h) {
     gWinW = (w<=0?1:w);
     gWinH = (h<=0?1:h);
 
@@ -963,6 +1280,10 @@ void reshape(int w, int h) {
 
     gWorldPerPixelX = (ViewMax.x - ViewMin.x) / (float)gWinW;
     gWorldPerPixelY = (ViewMax.y - ViewMin.y) / (float)gWinH;
+}
+
+void reshape(int w, int h) {
+    CalculaVisao(w, h);
 
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
@@ -975,31 +1296,19 @@ void reshape(int w, int h) {
 void animate() {
     double dt = T.getDeltaT();
     AccumDeltaT += dt;
-    AccumLogic  += dt;
 
-    // cooldown de tiro
-    if (gFireCooldownLeft > 0.0) {
-        gFireCooldownLeft -= dt;
-        if (gFireCooldownLeft < 0.0) gFireCooldownLeft = 0.0;
-    }
-
-    if (gState == GameState::COUNTDOWN) {
-        countdownRemaining -= dt;
-        if (countdownRemaining <= 0.0) {
-            countdownRemaining = 0.0;
-            BeginPlaying(); // só aqui começa a entrar inimigo, gradualmente
+    const double passo = 1.0 / FrequenciaSimulacao;
+    AccumSimulacao += dt;
+    int nPassos = 0;
+    while (AccumSimulacao >= passo) {
+        if (nPassos == MAX_PASSOS_POR_QUADRO) {
+            PassosDescartados += (long)(AccumSimulacao / passo);
+            AccumSimulacao = fmod(AccumSimulacao, passo);
+            break;
         }
-    } else if (gState == GameState::PLAYING) {
-        gameTime += dt;
-        if (goTimer > 0.0) goTimer -= dt;
-
-        if (AccumLogic >= 0.1) {
-            float step = (float)AccumLogic;
-            AccumLogic = 0.0f;
-            AtualizaInimigosIA(step);
-            ProcessaRespawn(step);
-        }
-        AtualizaPersonagens((float)dt);
+        PassoDoJogo(passo);
+        AccumSimulacao -= passo;
+        nPassos++;
     }
 
     if (AccumDeltaT >= 1.0/30.0) {
@@ -1062,6 +1371,23 @@ void keyboardDown(unsigned char key, int, int) {
                 break;
             case 'e':
             case 'E': desenhaEnvelope = !desenhaEnvelope; break;
+            case 'i':
+            case 'I': UsaLotes = !UsaLotes; break;
+            case 'b':
+            case 'B':
+                UsaArvore = !UsaArvore;
+                LimpaArvoreDeColisao(); // refeita no proximo passo
+                cout << "Broadphase: " << (UsaArvore ? "arvore" : "grade") << endl;
+                break;
+            case '+':
+            case '=':
+                TamanhoCelulaGrade *= 1.25f;
+                cout << "Celula da grade: " << TamanhoCelulaGrade << endl;
+                break;
+            case '-':
+                TamanhoCelulaGrade = std::max(0.5f, TamanhoCelulaGrade / 1.25f);
+                cout << "Celula da grade: " << TamanhoCelulaGrade << endl;
+                break;
             default: break;
         }
     }
@@ -1084,19 +1410,131 @@ void specialUp(int k, int, int) {
 // ---------------------------------------------------------------------
 // Init / Main
 // ---------------------------------------------------------------------
-void init() {
-    glClearColor(0.05f, 0.05f, 0.08f, 1.0f);
-
+void InicializaMundo() {
     CarregaModelos();
+    Entidades.reserva(MAX_INSTANCIAS);
 
     float d = 20.0f;
     Min = Ponto(-d, -d);
     Max = Ponto( d,  d);
+}
+
+void init() {
+    glClearColor(0.05f, 0.05f, 0.08f, 1.0f);
+
+    InicializaMundo();
+    CompilaModelos();
 
     reshape(gWinW, gWinH); // prepara viewport
 }
 
+// ---------------------------------------------------------------------
+// Modo sem janela: simulação com dt fixo, o mais rápido possível
+// ---------------------------------------------------------------------
+
+// Entrada roteirizada do jogador: acelera, gira e atira em ciclos,
+// só em função do tempo de jogo (repetível)
+void JogadorAutomatico() {
+    double t = gameTime;
+    keyDown['w'] = fmod(t, 3.0) < 1.5;
+    keyDown['a'] = fmod(t, 5.0) < 2.0;
+    keyDown['d'] = !keyDown['a'] && fmod(t, 7.0) < 2.5;
+    if (gFireCooldownLeft <= 0.0) {
+        CriaTiro();
+        gFireCooldownLeft = PLAYER_FIRE_COOLDOWN;
+    }
+}
+
+int ExecutaSemJanela(long nPassos, unsigned long semente) {
+    const double DT = 1.0 / FrequenciaSimulacao;
+
+    rng.seed(semente);
+    InicializaMundo();
+    CalculaVisao(gWinW, gWinH);
+
+    ResetMatch();
+    BeginPlaying();
+    // Carga fixa: o spawn não sobrepõe inimigos, então a tela enche aos
+    // poucos; os passos até chegar ao limite não entram na medição
+    long aquecimento = 0;
+    if (CargaFixa) {
+        const long MAX_AQUECIMENTO = (long)(60 * FrequenciaSimulacao); // 60 s de jogo
+        PreencheInimigosAteOLimite();
+        while (ContaInimigosVivos() < MAX_ENEMIES_ONSCREEN && aquecimento < MAX_AQUECIMENTO) {
+            JogadorAutomatico();
+            PassoDoJogo(DT);
+            PreencheInimigosAteOLimite();
+            aquecimento++;
+        }
+    }
+
+    TemposDasFases tempos;
+    int partidas = 1;
+    double somaInimigos = 0;
+    double reposicao = 0; // carga fixa: tempo repondo inimigos, descontado
+    Relogio::time_point inicio = Relogio::now();
+    for (long passo=0; passo<nPassos; ++passo) {
+        if (gState == GameState::GAMEOVER) { // recomeça para manter a carga
+            ResetMatch();
+            BeginPlaying();
+            partidas++;
+        }
+        JogadorAutomatico();
+        PassoDoJogo(DT, &tempos);
+        somaInimigos += ContaInimigosVivos();
+        if (CargaFixa) {
+            Relogio::time_point r = Relogio::now();
+            PreencheInimigosAteOLimite();
+            reposicao += Segundos(r, Relogio::now());
+        }
+    }
+    double total = Segundos(inicio, Relogio::now()) - reposicao;
+
+    cout << fixed << setprecision(3);
+    cout << "Passos: " << nPassos << "  (dt = 1/" << setprecision(0) << FrequenciaSimulacao
+         << " s, semente " << semente << ")" << endl;
+    if (CargaFixa)
+        cout << "Carga fixa: " << aquecimento << " passos de aquecimento e "
+             << reposicao * 1000.0 << " ms repondo inimigos, fora da medicao" << endl;
+    cout << setprecision(3);
+    cout << "Tempo total: " << total << " s  |  Passos/s: " << setprecision(0) << nPassos / max(total, 1e-9) << endl;
+    cout << setprecision(3);
+    cout << "Tempo por fase (ms total, us/passo):" << endl;
+    const char* nomes[] = {"IA", "Respawn", "Movimento", "Colisao"};
+    double valores[] = {tempos.IA, tempos.Respawn, tempos.Movimento, tempos.Colisao};
+    for (int k=0; k<4; ++k)
+        cout << "  " << setw(10) << left << nomes[k] << right
+             << setw(10) << valores[k]*1000.0 << setw(10) << valores[k]*1e6/nPassos << endl;
+    cout << "Partidas: " << partidas << "  |  Score: " << Score << "  |  Vidas: " << Vidas
+         << "  |  Entidades: " << Entidades.tamanho()
+         << "  |  Inimigos: " << Entidades.conta(CAT_INIMIGO) << " de " << MAX_ENEMIES_ONSCREEN
+         << "  (media " << setprecision(1) << somaInimigos / max(nPassos, 1L) << ")" << endl;
+    if (UsaArvore)
+        cout << "Arvore: " << TotalAtualizacoesDaArvore << " atualizacoes ("
+             << setprecision(3) << (double)TotalAtualizacoesDaArvore / nPassos << " por passo)" << endl;
+    cout << "Hash do estado: 0x" << hex << setw(16) << setfill('0') << HashDoEstado() << dec << endl;
+    return 0;
+}
+
 int main(int argc, char** argv) {
+    bool semJanela = false, cargaFixa = false;
+    long nPassos = 10000;
+    unsigned long semente = 123456;
+    for (int i=1; i<argc; ++i) {
+        if (!strcmp(argv[i], "--headless")) semJanela = true;
+        else if (!strcmp(argv[i], "--ticks") && i+1<argc) nPassos = max(1L, atol(argv[++i]));
+        else if (!strcmp(argv[i], "--seed") && i+1<argc) semente = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--hz") && i+1<argc) FrequenciaSimulacao = max(1.0, atof(argv[++i]));
+        else if (!strcmp(argv[i], "--broadphase") && i+1<argc) UsaArvore = !strcmp(argv[++i], "arvore");
+        else if (!strcmp(argv[i], "--carga-fixa")) cargaFixa = true;
+        else if (!strcmp(argv[i], "--inimigos") && i+1<argc) {
+            MAX_ENEMIES_ONSCREEN = atoi(argv[++i]);
+            QtdInimigos = MAX_ENEMIES_ONSCREEN;
+        }
+    }
+    CargaFixa = semJanela && cargaFixa;
+    if (semJanela) return ExecutaSemJanela(nPassos, semente);
+
     cout << "Programa OpenGL - T1 CG" << endl;
 
     glutInit(&argc, argv);
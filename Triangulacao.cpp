@@ -0,0 +1,417 @@
+//
+//  Triangulacao.cpp
+//  OpenGLTest
+//
+
+#include <algorithm>
+#include <set>
+#include <cmath>
+using namespace std;
+
+#include "Triangulacao.h"
+
+// > 0 se C esta a esquerda de A->B
+static inline double Cruz(const Ponto &A, const Ponto &B, const Ponto &C)
+{
+    return ((double)B.x - A.x) * ((double)C.y - A.y) - ((double)B.y - A.y) * ((double)C.x - A.x);
+}
+
+// Ordem da varredura: maior y primeiro; no empate, menor x primeiro
+static inline bool Acima(const Ponto &P, const Ponto &Q)
+{
+    return P.y > Q.y || (P.y == Q.y && P.x < Q.x);
+}
+
+// **********************************************************************
+//  Estado da varredura: arestas que cortam a linha de varredura e tem o
+//  interior do poligono a direita, ordenadas pelo x na altura atual.
+//  A aresta a vai do vertice a ao vertice a+1 (sentido anti-horario).
+// **********************************************************************
+struct VarreduraMonotona
+{
+    const vector<Ponto> *P;
+    int n;
+    double YAtual;
+    double XSonda; // x do "vertice" usado nas buscas (aresta -1)
+
+    double XNaAltura(int a) const
+    {
+        if (a < 0)
+            return XSonda;
+        const Ponto &A = (*P)[a];
+        const Ponto &B = (*P)[(a + 1) % n];
+        if (A.y == B.y)
+            return min(A.x, B.x);
+        if (YAtual == A.y) return A.x;
+        if (YAtual == B.y) return B.x;
+        return A.x + (YAtual - A.y) * ((double)B.x - A.x) / ((double)B.y - A.y);
+    }
+};
+
+struct ComparaArestas
+{
+    const VarreduraMonotona *V;
+    bool operator()(int a, int b) const
+    {
+        if (a == b)
+            return false;
+        double xa = V->XNaAltura(a), xb = V->XNaAltura(b);
+        if (xa != xb)
+            return xa < xb;
+        if (a < 0 || b < 0)
+            return a < 0; // a sonda fica antes das arestas que passam pelo mesmo x
+        // Arestas que se tocam na altura atual: a mais a esquerda logo
+        // abaixo vem antes
+        const vector<Ponto> &P = *V->P;
+        const Ponto &A1 = P[a], &A2 = P[(a + 1) % V->n];
+        const Ponto &B1 = P[b], &B2 = P[(b + 1) % V->n];
+        double da = (A1.y != A2.y) ? ((double)A2.x - A1.x) / ((double)A1.y - A2.y) : 1e300;
+        double db = (B1.y != B2.y) ? ((double)B2.x - B1.x) / ((double)B1.y - B2.y) : 1e300;
+        if (A1.y < A2.y) da = -da;
+        if (B1.y < B2.y) db = -db;
+        if (da != db)
+            return da < db;
+        return a < b;
+    }
+};
+
+enum TipoDeVertice
+{
+    V_INICIO,
+    V_FIM,
+    V_DIVISAO,
+    V_JUNCAO,
+    V_REGULAR
+};
+
+// Acrescenta em Diagonais as diagonais que dividem o poligono P
+// (anti-horario, sem vertices repetidos) em pedacos monotonos em y
+static void DiagonaisMonotonas(const vector<Ponto> &P, vector<pair<int, int> > &Diagonais)
+{
+    int n = (int)P.size();
+    vector<int> Ordem(n);
+    for (int i = 0; i < n; i++)
+        Ordem[i] = i;
+    sort(Ordem.begin(), Ordem.end(), [&P](int a, int b) { return Acima(P[a], P[b]); });
+
+    vector<TipoDeVertice> Tipo(n);
+    for (int i = 0; i < n; i++)
+    {
+        const Ponto &Ant = P[(i + n - 1) % n], &V = P[i], &Prox = P[(i + 1) % n];
+        bool antAbaixo = Acima(V, Ant), proxAbaixo = Acima(V, Prox);
+        bool convexo = Cruz(Ant, V, Prox) > 0;
+        if (antAbaixo && proxAbaixo)
+            Tipo[i] = convexo ? V_INICIO : V_DIVISAO;
+        else if (!antAbaixo && !proxAbaixo)
+            Tipo[i] = convexo ? V_FIM : V_JUNCAO;
+        else
+            Tipo[i] = V_REGULAR;
+    }
+
+    VarreduraMonotona Var;
+    Var.P = &P;
+    Var.n = n;
+    Var.YAtual = 0;
+    Var.XSonda = 0;
+    ComparaArestas Comp;
+    Comp.V = &Var;
+    typedef set<int, ComparaArestas> Estado;
+    Estado T(Comp);
+    vector<Estado::iterator> PosicaoNoEstado(n, T.end());
+    vector<int> Ajudante(n, -1);
+
+    // Aresta do estado imediatamente a esquerda do vertice v
+    auto ArestaAEsquerda = [&](int v) -> int {
+        Var.XSonda = P[v].x;
+        Estado::iterator it = T.lower_bound(-1);
+        if (it == T.begin())
+            return -1;
+        --it;
+        return *it;
+    };
+    auto Insere = [&](int a, int ajudante) {
+        PosicaoNoEstado[a] = T.insert(a).first;
+        Ajudante[a] = ajudante;
+    };
+    auto Remove = [&](int a) {
+        if (PosicaoNoEstado[a] != T.end())
+        {
+            T.erase(PosicaoNoEstado[a]);
+            PosicaoNoEstado[a] = T.end();
+        }
+    };
+
+    for (int k = 0; k < n; k++)
+    {
+        int v = Ordem[k];
+        int ant = (v + n - 1) % n; // aresta que chega em v
+        Var.YAtual = P[v].y;
+        switch (Tipo[v])
+        {
+        case V_INICIO:
+            Insere(v, v);
+            break;
+        case V_FIM:
+            if (Ajudante[ant] >= 0 && Tipo[Ajudante[ant]] == V_JUNCAO)
+                Diagonais.push_back(make_pair(v, Ajudante[ant]));
+            Remove(ant);
+            break;
+        case V_DIVISAO:
+        {
+            int e = ArestaAEsquerda(v);
+            if (e >= 0)
+            {
+                Diagonais.push_back(make_pair(v, Ajudante[e]));
+                Ajudante[e] = v;
+            }
+            Insere(v, v);
+            break;
+        }
+        case V_JUNCAO:
+        {
+            if (Ajudante[ant] >= 0 && Tipo[Ajudante[ant]] == V_JUNCAO)
+                Diagonais.push_back(make_pair(v, Ajudante[ant]));
+            Remove(ant);
+            int e = ArestaAEsquerda(v);
+            if (e >= 0)
+            {
+                if (Tipo[Ajudante[e]] == V_JUNCAO)
+                    Diagonais.push_back(make_pair(v, Ajudante[e]));
+                Ajudante[e] = v;
+            }
+            break;
+        }
+        case V_REGULAR:
+            // Interior a direita: a cadeia desce por v
+            if (Acima(P[ant], P[v]))
+            {
+                if (Ajudante[ant] >= 0 && Tipo[Ajudante[ant]] == V_JUNCAO)
+                    Diagonais.push_back(make_pair(v, Ajudante[ant]));
+                Remove(ant);
+                Insere(v, v);
+            }
+            else
+            {
+                int e = ArestaAEsquerda(v);
+                if (e >= 0)
+                {
+                    if (Tipo[Ajudante[e]] == V_JUNCAO)
+                        Diagonais.push_back(make_pair(v, Ajudante[e]));
+                    Ajudante[e] = v;
+                }
+            }
+            break;
+        }
+    }
+}
+
+// **********************************************************************
+//  Separacao em faces: cada vertice conhece as semi-arestas que saem
+//  dele, ordenadas pelo angulo. Percorrendo as faces com o interior a
+//  esquerda, a semi-aresta seguinte a (a->b) eh a que sai de b logo
+//  depois de (b->a) no sentido horario.
+// **********************************************************************
+static bool SeparaFaces(const vector<Ponto> &P, const vector<pair<int, int> > &Diagonais,
+                        vector<vector<int> > &Faces)
+{
+    int n = (int)P.size();
+    vector<vector<int> > Saidas(n);
+    for (int i = 0; i < n; i++)
+    {
+        Saidas[i].push_back((i + 1) % n);
+        Saidas[i].push_back((i + n - 1) % n);
+    }
+    for (size_t d = 0; d < Diagonais.size(); d++)
+    {
+        Saidas[Diagonais[d].first].push_back(Diagonais[d].second);
+        Saidas[Diagonais[d].second].push_back(Diagonais[d].first);
+    }
+    // Ordena pelo angulo (anti-horario) e guarda, para cada semi-aresta,
+    // se ja foi percorrida
+    vector<vector<char> > Usada(n);
+    for (int v = 0; v < n; v++)
+    {
+        const Ponto &O = P[v];
+        sort(Saidas[v].begin(), Saidas[v].end(), [&](int a, int b) {
+            return atan2((double)P[a].y - O.y, (double)P[a].x - O.x) <
+                   atan2((double)P[b].y - O.y, (double)P[b].x - O.x);
+        });
+        Usada[v].assign(Saidas[v].size(), 0);
+    }
+    // As semi-arestas (i -> i-1) formam a borda externa, que nao eh face
+    for (int v = 0; v < n; v++)
+    {
+        int ant = (v + n - 1) % n;
+        for (size_t s = 0; s < Saidas[v].size(); s++)
+            if (Saidas[v][s] == ant)
+            {
+                Usada[v][s] = 1;
+                break;
+            }
+    }
+
+    size_t semiArestas = 0;
+    for (int v = 0; v < n; v++)
+        semiArestas += Saidas[v].size();
+    for (int v = 0; v < n; v++)
+        for (size_t s = 0; s < Saidas[v].size(); s++)
+        {
+            if (Usada[v][s])
+                continue;
+            vector<int> Face;
+            int a = v, sa = (int)s;
+            size_t passos = 0;
+            while (!Usada[a][sa])
+            {
+                if (++passos > semiArestas)
+                    return false;
+                Usada[a][sa] = 1;
+                Face.push_back(a);
+                int b = Saidas[a][sa];
+                // posicao de (b->a) entre as saidas de b; a seguinte no
+                // sentido horario eh a anterior na ordem anti-horaria
+                const vector<int> &Sb = Saidas[b];
+                int k = (int)(find(Sb.begin(), Sb.end(), a) - Sb.begin());
+                int m = (int)Sb.size();
+                sa = (k + m - 1) % m;
+                a = b;
+            }
+            if (a != v || Face.size() < 3)
+                return false;
+            Faces.push_back(Face);
+        }
+    return true;
+}
+
+// **********************************************************************
+//  Triangulacao de um pedaco monotono em y (anti-horario)
+// **********************************************************************
+static bool TriangulaMonotono(const vector<Ponto> &P, const vector<int> &Face, vector<int> &Triangulos)
+{
+    int k = (int)Face.size();
+    if (k == 3)
+    {
+        Triangulos.insert(Triangulos.end(), Face.begin(), Face.end());
+        return true;
+    }
+    // Vertice mais alto e mais baixo; descendo no sentido anti-horario
+    // a partir do topo percorre-se a cadeia da esquerda
+    int topo = 0, fundo = 0;
+    for (int i = 1; i < k; i++)
+    {
+        if (Acima(P[Face[i]], P[Face[topo]])) topo = i;
+        if (Acima(P[Face[fundo]], P[Face[i]])) fundo = i;
+    }
+    vector<char> NaEsquerda(k, 0);
+    for (int i = topo; i != fundo; i = (i + 1) % k)
+        NaEsquerda[i] = 1;
+
+    // Vertices de cima para baixo (posicoes em Face)
+    vector<int> U(k);
+    for (int i = 0; i < k; i++)
+        U[i] = i;
+    sort(U.begin(), U.end(), [&](int a, int b) { return Acima(P[Face[a]], P[Face[b]]); });
+
+    auto Triangulo = [&](int a, int b, int c) {
+        int ia = Face[a], ib = Face[b], ic = Face[c];
+        if (Cruz(P[ia], P[ib], P[ic]) < 0)
+            swap(ib, ic);
+        Triangulos.push_back(ia);
+        Triangulos.push_back(ib);
+        Triangulos.push_back(ic);
+    };
+
+    vector<int> Pilha;
+    Pilha.push_back(U[0]);
+    Pilha.push_back(U[1]);
+    for (int j = 2; j < k - 1; j++)
+    {
+        int uj = U[j];
+        if (NaEsquerda[uj] != NaEsquerda[Pilha.back()])
+        {
+            // Cadeia oposta: liga uj a todos os vertices da pilha
+            for (size_t s = 0; s + 1 < Pilha.size(); s++)
+                Triangulo(uj, Pilha[s], Pilha[s + 1]);
+            int topoDaPilha = Pilha.back();
+            Pilha.clear();
+            Pilha.push_back(topoDaPilha);
+            Pilha.push_back(uj);
+        }
+        else
+        {
+            // Mesma cadeia: liga enquanto o vertice do meio for convexo
+            int ultimo = Pilha.back();
+            Pilha.pop_back();
+            while (!Pilha.empty())
+            {
+                int s = Pilha.back();
+                double c = NaEsquerda[uj] ? Cruz(P[Face[s]], P[Face[ultimo]], P[Face[uj]])
+                                          : Cruz(P[Face[uj]], P[Face[ultimo]], P[Face[s]]);
+                if (c <= 0)
+                    break;
+                Triangulo(uj, ultimo, s);
+                ultimo = s;
+                Pilha.pop_back();
+            }
+            Pilha.push_back(ultimo);
+            Pilha.push_back(uj);
+        }
+    }
+    // O ultimo vertice liga a todos os que sobraram
+    int ultimoU = U[k - 1];
+    for (size_t s = 0; s + 1 < Pilha.size(); s++)
+        Triangulo(ultimoU, Pilha[s], Pilha[s + 1]);
+    return true;
+}
+
+// **********************************************************************
+bool TriangulaPoligono(const vector<Ponto> &V, vector<unsigned> &Indices)
+{
+    Indices.clear();
+
+    // Tira os vertices repetidos em sequencia; Original[i] eh o indice
+    // em V do i-esimo vertice mantido
+    vector<unsigned> Original;
+    for (size_t i = 0; i < V.size(); i++)
+        if (Original.empty() || !(V[i].x == V[Original.back()].x && V[i].y == V[Original.back()].y))
+            Original.push_back((unsigned)i);
+    while (Original.size() > 1 && V[Original.back()].x == V[Original[0]].x && V[Original.back()].y == V[Original[0]].y)
+        Original.pop_back();
+    int n = (int)Original.size();
+    if (n < 3)
+        return false;
+
+    // Trabalha com o poligono no sentido anti-horario
+    double area2 = 0;
+    for (int i = 0; i < n; i++)
+    {
+        const Ponto &A = V[Original[i]], &B = V[Original[(i + 1) % n]];
+        area2 += (double)A.x * B.y - (double)B.x * A.y;
+    }
+    if (area2 == 0)
+        return false;
+    if (area2 < 0)
+        reverse(Original.begin(), Original.end());
+    vector<Ponto> P(n);
+    for (int i = 0; i < n; i++)
+        P[i] = V[Original[i]];
+
+    vector<pair<int, int> > Diagonais;
+    DiagonaisMonotonas(P, Diagonais);
+    vector<vector<int> > Faces;
+    if (!SeparaFaces(P, Diagonais, Faces))
+        return false;
+
+    vector<int> Triangulos;
+    Triangulos.reserve(3 * (n - 2));
+    for (size_t f = 0; f < Faces.size(); f++)
+        if (!TriangulaMonotono(P, Faces[f], Triangulos))
+            return false;
+    if ((int)Triangulos.size() != 3 * (n - 2))
+        return false; // so acontece com arestas que se cruzam
+
+    Indices.resize(Triangulos.size());
+    for (size_t i = 0; i < Triangulos.size(); i++)
+        Indices[i] = Original[Triangulos[i]];
+    return true;
+}
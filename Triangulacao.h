@@ -0,0 +1,31 @@
+//
+//  Triangulacao.h
+//  OpenGLTest
+//
+//  Triangulacao de poligonos simples (concavos ou nao) em O(n log n):
+//
+//   1. uma varredura de cima para baixo classifica os vertices (inicio,
+//      fim, divisao, juncao, regular) e acrescenta as diagonais que
+//      quebram o poligono em pedacos monotonos em y;
+//   2. cada pedaco monotono eh triangulado em tempo linear com uma
+//      pilha.
+//
+//  Vertices repetidos em sequencia (como o ultimo igual ao primeiro
+//  nos arquivos de mapa) sao ignorados. O resultado sao triplas de
+//  indices para o vetor original, em sentido anti-horario.
+//
+
+#ifndef Triangulacao_hpp
+#define Triangulacao_hpp
+
+#include <vector>
+using namespace std;
+
+#include "Ponto.h"
+
+// Retorna false se o poligono nao pode ser triangulado (menos de 3
+// vertices distintos, area zero ou arestas que se cruzam); nesse caso
+// Indices pode ficar incompleto.
+bool TriangulaPoligono(const vector<Ponto> &V, vector<unsigned> &Indices);
+
+#endif /* Triangulacao_hpp */
@@ -0,0 +1,224 @@
+//
+//  TrianguloDeConsulta.cpp
+//  OpenGLTest
+//
+
+#include "TrianguloDeConsulta.h"
+
+// SSE2 faz parte de todo x86-64; AVX2 eh compilado so para as funcoes
+// que o usam e escolhido em tempo de execucao
+#if defined(__SSE2__) || defined(_M_X64)
+#define TEM_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(TEM_SSE2) && defined(__GNUC__) && defined(__x86_64__)
+#define TEM_AVX2
+#include <immintrin.h>
+#endif
+
+TrianguloDeConsulta::TrianguloDeConsulta(const Ponto &P0, const Ponto &P1, const Ponto &P2)
+{
+    V[0] = P0;
+    V[1] = P1;
+    V[2] = P2;
+    float area2 = (P1.x - P0.x) * (P2.y - P0.y) - (P1.y - P0.y) * (P2.x - P0.x);
+    if (area2 < 0)
+        swap(V[1], V[2]);
+    Degenerado = (area2 == 0);
+
+    for (int k = 0; k < 3; k++)
+    {
+        if (Degenerado)
+        {
+            a[k] = b[k] = 0;
+            c[k] = -1;
+            continue;
+        }
+        const Ponto &A = V[k];
+        const Ponto &B = V[(k + 1) % 3];
+        // (B - A) x (P - A) >= 0 do lado esquerdo da aresta
+        a[k] = A.y - B.y;
+        b[k] = B.x - A.x;
+        c[k] = -(a[k] * A.x + b[k] * A.y);
+    }
+    Caixa = AABB::DosPontos(V, 3);
+}
+
+// Eixos separadores: os dois eixos da caixa (comparando com a caixa
+// do triangulo) e as normais das tres arestas (a caixa inteira do lado
+// de fora de uma aresta)
+bool TrianguloDeConsulta::intersectaCaixa(const AABB &B) const
+{
+    if (!Caixa.intersecta(B))
+        return false;
+    for (int k = 0; k < 3; k++)
+    {
+        // canto da caixa mais para dentro da aresta k
+        float x = (a[k] >= 0) ? B.maxX : B.minX;
+        float y = (b[k] >= 0) ? B.maxY : B.minY;
+        if (aresta(k, x, y) < 0)
+            return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------
+// Teste em bloco (x[], y[])
+// ----------------------------------------------------------------------
+// Escreve o id de cada lane marcada em "mascara". A escrita eh feita
+// para toda lane e so o contador depende do bit, o que evita desvios;
+// como m <= base + l, nunca passa do espaco de n valores.
+static inline int Compacta(unsigned mascara, int largura, int base, const int *ids, int *Saida, int m)
+{
+    if (mascara == 0)
+        return m;
+    for (int l = 0; l < largura; l++)
+    {
+        Saida[m] = ids ? ids[base + l] : base + l;
+        m += (mascara >> l) & 1;
+    }
+    return m;
+}
+
+static int FiltraEscalar(const float *x, const float *y, const int *ids, int inicio, int n,
+                         const TrianguloDeConsulta &T, int *Saida, int m)
+{
+    for (int k = inicio; k < n; k++)
+        if (T.contem(x[k], y[k]))
+            Saida[m++] = ids ? ids[k] : k;
+    return m;
+}
+
+#ifdef TEM_SSE2
+static int FiltraSSE2(const float *x, const float *y, const int *ids, int n,
+                      const TrianguloDeConsulta &T, int *Saida)
+{
+    __m128 a[3], b[3], c[3];
+    for (int e = 0; e < 3; e++)
+    {
+        a[e] = _mm_set1_ps(T.a[e]);
+        b[e] = _mm_set1_ps(T.b[e]);
+        c[e] = _mm_set1_ps(T.c[e]);
+    }
+    __m128 zero = _mm_setzero_ps();
+    int m = 0, k = 0;
+    for (; k + 4 <= n; k += 4)
+    {
+        __m128 px = _mm_loadu_ps(x + k), py = _mm_loadu_ps(y + k);
+        __m128 dentro = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int e = 0; e < 3; e++)
+        {
+            // (a*x + b*y) + c, como em TrianguloDeConsulta::aresta
+            __m128 f = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[e], px), _mm_mul_ps(b[e], py)), c[e]);
+            dentro = _mm_and_ps(dentro, _mm_cmpge_ps(f, zero));
+        }
+        m = Compacta((unsigned)_mm_movemask_ps(dentro), 4, k, ids, Saida, m);
+    }
+    return FiltraEscalar(x, y, ids, k, n, T, Saida, m);
+}
+#endif
+
+#ifdef TEM_AVX2
+__attribute__((target("avx2")))
+static int FiltraAVX2(const float *x, const float *y, const int *ids, int n,
+                      const TrianguloDeConsulta &T, int *Saida)
+{
+    __m256 a[3], b[3], c[3];
+    for (int e = 0; e < 3; e++)
+    {
+        a[e] = _mm256_set1_ps(T.a[e]);
+        b[e] = _mm256_set1_ps(T.b[e]);
+        c[e] = _mm256_set1_ps(T.c[e]);
+    }
+    __m256 zero = _mm256_setzero_ps();
+    int m = 0, k = 0;
+    for (; k + 8 <= n; k += 8)
+    {
+        __m256 px = _mm256_loadu_ps(x + k), py = _mm256_loadu_ps(y + k);
+        __m256 dentro = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int e = 0; e < 3; e++)
+        {
+            // sem FMA: o arredondamento tem que ser o mesmo do escalar
+            __m256 f = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a[e], px), _mm256_mul_ps(b[e], py)), c[e]);
+            dentro = _mm256_and_ps(dentro, _mm256_cmp_ps(f, zero, _CMP_GE_OQ));
+        }
+        m = Compacta((unsigned)_mm256_movemask_ps(dentro), 8, k, ids, Saida, m);
+    }
+    return FiltraEscalar(x, y, ids, k, n, T, Saida, m);
+}
+#endif
+
+bool KernelDisponivel(KernelDoTriangulo k)
+{
+    switch (k)
+    {
+    case KERNEL_AUTOMATICO:
+    case KERNEL_ESCALAR:
+        return true;
+#ifdef TEM_SSE2
+    case KERNEL_SSE2:
+        return true;
+#endif
+#ifdef TEM_AVX2
+    case KERNEL_AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+const char *NomeDoKernel(KernelDoTriangulo k)
+{
+    const char *Nomes[] = {"automatico", "escalar", "SSE2", "AVX2"};
+    return Nomes[k];
+}
+
+static KernelDoTriangulo KernelMaisRapido()
+{
+    static const KernelDoTriangulo k = KernelDisponivel(KERNEL_AVX2) ? KERNEL_AVX2
+                                     : KernelDisponivel(KERNEL_SSE2) ? KERNEL_SSE2
+                                                                     : KERNEL_ESCALAR;
+    return k;
+}
+
+int FiltraPontosNoTriangulo(const float *x, const float *y, const int *ids, int n,
+                            const TrianguloDeConsulta &T, int *Saida, KernelDoTriangulo kernel)
+{
+    if (kernel == KERNEL_AUTOMATICO || !KernelDisponivel(kernel))
+        kernel = KernelMaisRapido();
+    switch (kernel)
+    {
+#ifdef TEM_AVX2
+    case KERNEL_AVX2:
+        return FiltraAVX2(x, y, ids, n, T, Saida);
+#endif
+#ifdef TEM_SSE2
+    case KERNEL_SSE2:
+        return FiltraSSE2(x, y, ids, n, T, Saida);
+#endif
+    default:
+        return FiltraEscalar(x, y, ids, 0, n, T, Saida, 0);
+    }
+}
+
+void AcrescentaPontosNoTriangulo(const float *x, const float *y, const int *ids, int n,
+                                 const TrianguloDeConsulta &T, vector<int> &Dentro)
+{
+    size_t antes = Dentro.size();
+    Dentro.resize(antes + n);
+    int m = FiltraPontosNoTriangulo(x, y, ids, n, T, Dentro.data() + antes);
+    Dentro.resize(antes + m);
+}
+
+void PontosNoTrianguloForcaBruta(const vector<Ponto> &Pontos, const TrianguloDeConsulta &T,
+                                 vector<int> &Dentro, ContadoresDaConsulta *Contadores)
+{
+    Dentro.clear();
+    int n = (int)Pontos.size();
+    for (int i = 0; i < n; i++)
+        if (T.contem(Pontos[i].x, Pontos[i].y))
+            Dentro.push_back(i);
+    if (Contadores)
+        Contadores->PontosTestados += n;
+}
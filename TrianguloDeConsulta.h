@@ -0,0 +1,116 @@
+//
+//  TrianguloDeConsulta.h
+//  OpenGLTest
+//
+//  Triangulo preparado para consultas de pontos (campo de visao).
+//  Cada aresta vira uma funcao de aresta a*x + b*y + c, positiva do
+//  lado de dentro; com o triangulo em sentido anti-horario, um ponto
+//  esta dentro (ou na borda) quando as tres funcoes sao >= 0.
+//  Isso evita as chamadas a lado(), que montam Pontos temporarios e
+//  um produto vetorial completo para cada ponto.
+//
+//  Os indices espaciais (quadtree, kd-tree) usam tambem os testes com
+//  caixas: uma caixa que nao toca o triangulo eh descartada inteira e
+//  uma caixa inteiramente dentro eh aceita sem testar os seus pontos.
+//
+//  FiltraPontosNoTriangulo testa um bloco de pontos guardados em
+//  vetores separados x[] e y[] com instrucoes vetoriais: 4 pontos por
+//  instrucao com SSE2 e 8 com AVX2 (escolhido em tempo de execucao, se
+//  o processador tiver). Eh a varredura linear para nuvens pequenas e o
+//  teste das folhas dos indices. As contas sao as mesmas de contem(),
+//  na mesma ordem, entao todas as versoes dao o mesmo resultado.
+//
+
+#ifndef TrianguloDeConsulta_hpp
+#define TrianguloDeConsulta_hpp
+
+#include <vector>
+using namespace std;
+
+#include "Ponto.h"
+#include "AABB.h"
+
+struct TrianguloDeConsulta
+{
+    Ponto V[3];            // vertices em sentido anti-horario
+    float a[3], b[3], c[3]; // aresta k: de V[k] para V[(k+1)%3]
+    AABB Caixa;
+
+    // Triangulo de area zero (vertices colineares ou repetidos). Ele eh
+    // tratado como vazio: as tres funcoes de aresta ficam em -1, entao
+    // contem, intersectaCaixa, contemCaixa e FiltraPontosNoTriangulo
+    // rejeitam tudo, e a forca bruta e os indices dao o mesmo resultado.
+    // Sem isso as funcoes de aresta seriam 0 em toda a reta suporte e
+    // aceitariam pontos fora do segmento, que os indices cortam pela Caixa.
+    bool Degenerado;
+
+    TrianguloDeConsulta() {}
+    TrianguloDeConsulta(const Ponto &P0, const Ponto &P1, const Ponto &P2);
+
+    float aresta(int k, float x, float y) const
+    {
+        return a[k] * x + b[k] * y + c[k];
+    }
+
+    bool contem(float x, float y) const
+    {
+        return aresta(0, x, y) >= 0 && aresta(1, x, y) >= 0 && aresta(2, x, y) >= 0;
+    }
+
+    // true se a caixa e o triangulo tem algum ponto em comum
+    bool intersectaCaixa(const AABB &B) const;
+
+    // true se a caixa inteira esta dentro do triangulo
+    bool contemCaixa(const AABB &B) const
+    {
+        return contem(B.minX, B.minY) && contem(B.maxX, B.minY) &&
+               contem(B.maxX, B.maxY) && contem(B.minX, B.maxY);
+    }
+};
+
+// Trabalho feito por uma consulta
+struct ContadoresDaConsulta
+{
+    long NosVisitados;
+    long PontosTestados;      // com o teste de ponto no triangulo
+    long PontosAceitosEmBloco; // em caixas inteiramente dentro
+
+    ContadoresDaConsulta() { zera(); }
+    void zera() { NosVisitados = PontosTestados = PontosAceitosEmBloco = 0; }
+};
+
+enum KernelDoTriangulo
+{
+    KERNEL_AUTOMATICO, // o mais rapido disponivel
+    KERNEL_ESCALAR,
+    KERNEL_SSE2,
+    KERNEL_AVX2
+};
+
+bool KernelDisponivel(KernelDoTriangulo k);
+const char *NomeDoKernel(KernelDoTriangulo k);
+
+// Testa os pontos (x[k], y[k]), k = 0..n-1, e escreve em "Saida" o
+// ids[k] de cada ponto dentro ou na borda (ou o proprio k, se ids eh
+// nulo), em ordem crescente de k. Retorna quantos foram escritos.
+// Saida precisa ter espaco para n valores.
+int FiltraPontosNoTriangulo(const float *x, const float *y, const int *ids, int n,
+                            const TrianguloDeConsulta &T, int *Saida,
+                            KernelDoTriangulo kernel = KERNEL_AUTOMATICO);
+
+// Ate este numero de pontos, varrer todos com FiltraPontosNoTriangulo
+// sai mais barato que descer uma QuadTreeDePontos ou KdTreeDePontos
+// (medido com "Benchmark consultas"). Os indices nao usam o limite:
+// quem consulta escolhe entre a varredura e a arvore.
+const int LIMITE_DA_VARREDURA = 50000;
+
+// Acrescenta a "Dentro" o resultado de FiltraPontosNoTriangulo
+void AcrescentaPontosNoTriangulo(const float *x, const float *y, const int *ids, int n,
+                                 const TrianguloDeConsulta &T, vector<int> &Dentro);
+
+// Testa todos os pontos; "Dentro" recebe os indices dos que estao
+// dentro ou na borda, em ordem crescente
+void PontosNoTrianguloForcaBruta(const vector<Ponto> &Pontos, const TrianguloDeConsulta &T,
+                                 vector<int> &Dentro, ContadoresDaConsulta *Contadores = nullptr);
+
+#endif /* TrianguloDeConsulta_hpp */
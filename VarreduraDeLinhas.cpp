@@ -0,0 +1,389 @@
+//
+//  VarreduraDeLinhas.cpp
+//  OpenGLTest
+//
+//  A varredura anda da esquerda para a direita (x crescente e, para o
+//  mesmo x, y crescente). A fila de eventos guarda as extremidades das
+//  linhas e as interseccoes ja descobertas; a estrutura de status guarda
+//  as linhas que cruzam a reta de varredura, ordenadas por y.
+//
+
+#include <map>
+#include <set>
+#include <algorithm>
+#include <cmath>
+using namespace std;
+
+#include "VarreduraDeLinhas.h"
+
+// **********************************************************************
+//  Ordena os pares por (i,j) e remove os repetidos
+// **********************************************************************
+static bool MenorPar(const ParDeInterseccao &a, const ParDeInterseccao &b)
+{
+    if (a.i != b.i) return a.i < b.i;
+    return a.j < b.j;
+}
+static bool MesmoPar(const ParDeInterseccao &a, const ParDeInterseccao &b)
+{
+    return a.i == b.i && a.j == b.j;
+}
+
+// **********************************************************************
+//  Forca bruta: n(n-1)/2 chamadas de HaInterseccaoExata
+// **********************************************************************
+void CalculaInterseccoesForcaBruta(const Linha *linhas, int n, vector<ParDeInterseccao> &pares)
+{
+    Ponto PA, PB, PC, PD;
+    double s, t;
+
+    pares.clear();
+    for (int i = 0; i < n; i++)
+    {
+        PA.set(linhas[i].x1, linhas[i].y1);
+        PB.set(linhas[i].x2, linhas[i].y2);
+        for (int j = i + 1; j < n; j++)
+        {
+            PC.set(linhas[j].x1, linhas[j].y1);
+            PD.set(linhas[j].x2, linhas[j].y2);
+            if (HaInterseccaoExata(PA, PB, PC, PD))
+            {
+                ParDeInterseccao par;
+                par.i = i;
+                par.j = j;
+                if (!intersec2d(PA, PB, PC, PD, s, t))
+                    s = 0; // quase paralelas: o det arredondou para 0
+                par.P = PA + (PB - PA) * s;
+                pares.push_back(par);
+            }
+        }
+    }
+}
+
+// **********************************************************************
+//  Estruturas internas da varredura
+// **********************************************************************
+namespace {
+
+struct Segmento
+{
+    double x1, y1, x2, y2; // (x1,y1) < (x2,y2) em ordem (x,y)
+    double inclinacao;     // +HUGE_VAL para segmentos verticais
+};
+
+struct PontoDeEvento
+{
+    double x, y;
+};
+
+struct ComparaEvento
+{
+    bool operator()(const PontoDeEvento &a, const PontoDeEvento &b) const
+    {
+        if (a.x != b.x) return a.x < b.x;
+        return a.y < b.y;
+    }
+};
+
+// Estado compartilhado com o comparador do status
+vector<Segmento> Segs;
+double VarX, VarY;  // ponto de varredura atual
+double EPS;
+
+const int SONDA = -1; // "segmento" que representa o proprio ponto de varredura
+
+// Altura do segmento no x dado; o vertical fica na altura y dada
+double YEm(const Segmento &S, double x, double y)
+{
+    if (S.x1 == S.x2)
+        return max(S.y1, min(y, S.y2));
+    return S.y1 + (x - S.x1) * S.inclinacao;
+}
+
+double YNaVarredura(int s)
+{
+    if (s == SONDA) return VarY;
+    return YEm(Segs[s], VarX, VarY);
+}
+
+// Ordem das linhas logo a direita do ponto de varredura:
+// por y e, nos empates, pela inclinacao.
+struct ComparaStatus
+{
+    bool operator()(int a, int b) const
+    {
+        if (a == b) return false;
+        double ya = YNaVarredura(a);
+        double yb = YNaVarredura(b);
+        if (fabs(ya - yb) > EPS) return ya < yb;
+        if (a == SONDA) return true;
+        if (b == SONDA) return false;
+        if (Segs[a].inclinacao != Segs[b].inclinacao)
+            return Segs[a].inclinacao < Segs[b].inclinacao;
+        return a < b;
+    }
+};
+
+typedef map<PontoDeEvento, vector<int>, ComparaEvento> FilaDeEventos;
+typedef set<int, ComparaStatus> Status;
+
+// Usa a mesma medida do comparador (distancia em y no x da varredura),
+// para que "passa por P" e "empata com a sonda" sejam a mesma coisa
+bool Contem(int s, const PontoDeEvento &P)
+{
+    const Segmento &S = Segs[s];
+    if (P.x < S.x1 - EPS || P.x > S.x2 + EPS) return false;
+    if (P.y < min(S.y1, S.y2) - EPS || P.y > max(S.y1, S.y2) + EPS) return false;
+    return fabs(YNaVarredura(s) - P.y) <= EPS;
+}
+
+bool TerminaEm(int s, const PontoDeEvento &P)
+{
+    return Segs[s].x2 == P.x && Segs[s].y2 == P.y;
+}
+
+// Se a e b se cruzam, guarda o par como candidato e, caso o cruzamento
+// fique depois do ponto P, agenda o evento de interseccao
+void AgendaInterseccao(int a, int b, const PontoDeEvento &P, FilaDeEventos &Q,
+                       vector<ParDeInterseccao> &candidatos)
+{
+    if (a > b) swap(a, b); // mesma ordem sempre, para o calculo ser reproduzivel
+    const Segmento &A = Segs[a];
+    const Segmento &B = Segs[b];
+    double rx = A.x2 - A.x1, ry = A.y2 - A.y1;
+    double ux = B.x2 - B.x1, uy = B.y2 - B.y1;
+    double det = rx * uy - ry * ux;
+    if (det == 0.0) return; // paralelas
+
+    double qx = B.x1 - A.x1, qy = B.y1 - A.y1;
+    double s = (qx * uy - qy * ux) / det;
+    double t = (qx * ry - qy * rx) / det;
+    // Folga de EPS nas extremidades: o teste exato no final decide os toques
+    double folgaS = EPS / sqrt(rx*rx + ry*ry);
+    double folgaT = EPS / sqrt(ux*ux + uy*uy);
+    if (s < -folgaS || s > 1.0 + folgaS || t < -folgaT || t > 1.0 + folgaT) return;
+
+    // Um toque que os arredondamentos colocam sobre o proprio P nao
+    // gera evento novo, mas o par precisa ser registrado aqui
+    ParDeInterseccao par;
+    par.i = a;
+    par.j = b;
+    candidatos.push_back(par);
+
+    PontoDeEvento I;
+    I.x = A.x1 + rx * s;
+    I.y = A.y1 + ry * s;
+
+    // Encosta o ponto calculado nas extremidades proximas para nao
+    // criar dois eventos quase iguais (mas nunca para tras de P). As duas
+    // linhas precisam passar pela extremidade na medida do status; numa
+    // linha muito inclinada um deslocamento pequeno em x muda muito o y,
+    // e o evento deixaria de trocar a ordem das duas.
+    const double ext[4][2] = {{A.x1,A.y1},{A.x2,A.y2},{B.x1,B.y1},{B.x2,B.y2}};
+    for (int k = 0; k < 4; k++)
+        if (fabs(ext[k][0] - I.x) <= EPS && fabs(ext[k][1] - I.y) <= EPS &&
+            (ext[k][0] > P.x || (ext[k][0] == P.x && ext[k][1] > P.y)) &&
+            fabs(YEm(A, ext[k][0], ext[k][1]) - ext[k][1]) <= EPS &&
+            fabs(YEm(B, ext[k][0], ext[k][1]) - ext[k][1]) <= EPS)
+        {
+            I.x = ext[k][0];
+            I.y = ext[k][1];
+            break;
+        }
+
+    // O ponto tem que ficar dentro das caixas das duas linhas; isso tambem
+    // deixa exato o x do cruzamento com uma linha vertical
+    I.x = max(I.x, max(A.x1, B.x1));
+    I.x = min(I.x, min(A.x2, B.x2));
+    I.y = max(I.y, max(min(A.y1, A.y2), min(B.y1, B.y2)));
+    I.y = min(I.y, min(max(A.y1, A.y2), max(B.y1, B.y2)));
+
+    // So interessam cruzamentos estritamente depois de P; mesmo os muito
+    // proximos precisam virar evento, senao a ordem do status fica errada
+    if (I.x < P.x || (I.x == P.x && I.y <= P.y)) return;
+    Q[I]; // cria o evento, se ainda nao existir
+}
+
+} // namespace
+
+// **********************************************************************
+//  Bentley-Ottmann
+// **********************************************************************
+void CalculaInterseccoesVarredura(const Linha *linhas, int n, vector<ParDeInterseccao> &pares)
+{
+    FilaDeEventos Q;
+    vector<ParDeInterseccao> candidatos;
+
+    pares.clear();
+    Segs.resize(n);
+
+    double escala = 1.0;
+    for (int i = 0; i < n; i++)
+    {
+        Segmento &S = Segs[i];
+        S.x1 = linhas[i].x1; S.y1 = linhas[i].y1;
+        S.x2 = linhas[i].x2; S.y2 = linhas[i].y2;
+        if (S.x2 < S.x1 || (S.x2 == S.x1 && S.y2 < S.y1))
+        {
+            swap(S.x1, S.x2);
+            swap(S.y1, S.y2);
+        }
+        S.inclinacao = (S.x1 == S.x2) ? HUGE_VAL : (S.y2 - S.y1) / (S.x2 - S.x1);
+        escala = max(escala, max(max(fabs(S.x1), fabs(S.x2)), max(fabs(S.y1), fabs(S.y2))));
+    }
+    // As coordenadas de Linha sao float: a tolerancia cobre o arredondamento
+    // delas, para que um toque nao vire um quase-cruzamento
+    EPS = 1e-6 * escala;
+
+    for (int i = 0; i < n; i++)
+    {
+        const Segmento &S = Segs[i];
+        if (S.x1 == S.x2 && S.y1 == S.y2)
+            continue; // linha degenerada: HaInterseccaoExata nunca a considera
+        PontoDeEvento inicio = {S.x1, S.y1};
+        PontoDeEvento fim    = {S.x2, S.y2};
+        Q[inicio].push_back(i);
+        Q[fim];
+    }
+
+    Status T;
+    vector<Status::iterator> contem;
+    vector<int> todos, reinsere;
+    vector<int> marca(n, -1);
+    int nEvento = 0;
+
+    while (!Q.empty())
+    {
+        PontoDeEvento P = Q.begin()->first;
+        vector<int> U;
+        U.swap(Q.begin()->second);
+        Q.erase(Q.begin());
+        nEvento++;
+
+        // Linhas que comecam a menos de EPS de P (extremidades que deveriam
+        // coincidir mas foram arredondadas de formas diferentes) entram ja
+        // neste evento. Os eventos delas continuam na fila, para os fins de linha.
+        for (FilaDeEventos::iterator it = Q.begin(); it != Q.end() && it->first.x <= P.x + EPS; ++it)
+            if (fabs(it->first.y - P.y) <= EPS && !it->second.empty())
+            {
+                U.insert(U.end(), it->second.begin(), it->second.end());
+                it->second.clear();
+            }
+
+        VarX = P.x;
+        VarY = P.y;
+
+        // Linhas do status que passam por P: ficam contiguas, logo apos a sonda
+        contem.clear();
+        for (Status::iterator it = T.lower_bound(SONDA); it != T.end() && Contem(*it, P); ++it)
+            contem.push_back(it);
+
+        // Todas as linhas que passam por P se intersectam entre si
+        todos.assign(U.begin(), U.end());
+        for (size_t k = 0; k < contem.size(); k++)
+            todos.push_back(*contem[k]);
+        for (size_t a = 0; a < todos.size(); a++)
+            for (size_t b = a + 1; b < todos.size(); b++)
+            {
+                ParDeInterseccao par;
+                par.i = min(todos[a], todos[b]);
+                par.j = max(todos[a], todos[b]);
+                candidatos.push_back(par);
+            }
+
+        // Retira as que passam por P e recoloca as que continuam depois dele,
+        // agora na ordem logo a direita de P
+        reinsere.clear();
+        for (size_t k = 0; k < contem.size(); k++)
+        {
+            int s = *contem[k];
+            T.erase(contem[k]);
+            if (!TerminaEm(s, P))
+                reinsere.push_back(s);
+        }
+        for (size_t k = 0; k < U.size(); k++)
+            if (!TerminaEm(U[k], P))
+                reinsere.push_back(U[k]);
+
+        if (reinsere.empty())
+        {
+            Status::iterator acima = T.lower_bound(SONDA);
+            if (acima != T.end() && acima != T.begin())
+            {
+                Status::iterator abaixo = acima;
+                --abaixo;
+                AgendaInterseccao(*abaixo, *acima, P, Q, candidatos);
+            }
+            continue;
+        }
+
+        Status::iterator qualquer = T.end();
+        for (size_t k = 0; k < reinsere.size(); k++)
+        {
+            qualquer = T.insert(reinsere[k]).first;
+            marca[reinsere[k]] = nEvento;
+        }
+
+        // Extremos do grupo reinserido e seus vizinhos externos
+        Status::iterator primeiro = qualquer, ultimo = qualquer;
+        while (primeiro != T.begin())
+        {
+            Status::iterator ant = primeiro;
+            --ant;
+            if (marca[*ant] != nEvento) break;
+            primeiro = ant;
+        }
+        for (Status::iterator prox = ultimo; ++prox != T.end() && marca[*prox] == nEvento; )
+            ultimo = prox;
+
+        if (primeiro != T.begin())
+        {
+            Status::iterator abaixo = primeiro;
+            --abaixo;
+            AgendaInterseccao(*abaixo, *primeiro, P, Q, candidatos);
+        }
+        Status::iterator acima = ultimo;
+        ++acima;
+        if (acima != T.end())
+            AgendaInterseccao(*ultimo, *acima, P, Q, candidatos);
+    }
+
+    // Os candidatos passam pelo mesmo teste exato usado na forca bruta,
+    // o que tambem elimina os pares paralelos sobrepostos; intersec2d so
+    // da o ponto
+    sort(candidatos.begin(), candidatos.end(), MenorPar);
+    candidatos.erase(unique(candidatos.begin(), candidatos.end(), MesmoPar), candidatos.end());
+
+    Ponto PA, PB, PC, PD;
+    double s, t;
+    for (size_t k = 0; k < candidatos.size(); k++)
+    {
+        const Linha &L1 = linhas[candidatos[k].i];
+        const Linha &L2 = linhas[candidatos[k].j];
+        PA.set(L1.x1, L1.y1); PB.set(L1.x2, L1.y2);
+        PC.set(L2.x1, L2.y1); PD.set(L2.x2, L2.y2);
+        if (!HaInterseccaoExata(PA, PB, PC, PD))
+            continue;
+        if (!intersec2d(PA, PB, PC, PD, s, t))
+            s = 0; // quase paralelas: o det arredondou para 0
+        candidatos[k].P = PA + (PB - PA) * s;
+        pares.push_back(candidatos[k]);
+    }
+    Segs.clear();
+}
+
+// **********************************************************************
+//  Quantidade de pares presentes em apenas um dos resultados
+// **********************************************************************
+long ComparaInterseccoes(const vector<ParDeInterseccao> &A, const vector<ParDeInterseccao> &B)
+{
+    long diferentes = 0;
+    size_t a = 0, b = 0;
+    while (a < A.size() && b < B.size())
+    {
+        if (MesmoPar(A[a], B[b])) { a++; b++; }
+        else if (MenorPar(A[a], B[b])) { a++; diferentes++; }
+        else { b++; diferentes++; }
+    }
+    return diferentes + (long)(A.size() - a) + (long)(B.size() - b);
+}
@@ -0,0 +1,40 @@
+//
+//  VarreduraDeLinhas.h
+//  OpenGLTest
+//
+//  Calculo de todas as interseccoes entre um conjunto de linhas.
+//  Ha duas versoes:
+//   - forca bruta, O(n^2), mantida como referencia;
+//   - varredura (Bentley-Ottmann), O((n+k) log n), onde k eh o
+//     numero de pares que se intersectam.
+//
+
+#ifndef VarreduraDeLinhas_hpp
+#define VarreduraDeLinhas_hpp
+
+#include <vector>
+using namespace std;
+
+#include "Ponto.h"
+#include "Linha.h"
+
+// Par de linhas que se intersectam (i < j) e o ponto de interseccao
+struct ParDeInterseccao
+{
+    int i, j;
+    Ponto P;
+};
+
+// Testa todos os pares (i,j), i<j, com HaInterseccaoExata
+void CalculaInterseccoesForcaBruta(const Linha *linhas, int n, vector<ParDeInterseccao> &pares);
+
+// Algoritmo de varredura de Bentley-Ottmann.
+// Usa o mesmo criterio de HaInterseccaoExata: linhas paralelas nao se
+// intersectam e o toque nas extremidades conta como interseccao.
+void CalculaInterseccoesVarredura(const Linha *linhas, int n, vector<ParDeInterseccao> &pares);
+
+// Compara dois resultados (pares ordenados por i,j) e retorna
+// quantos pares aparecem em apenas um deles
+long ComparaInterseccoes(const vector<ParDeInterseccao> &A, const vector<ParDeInterseccao> &B);
+
+#endif /* VarreduraDeLinhas_hpp */